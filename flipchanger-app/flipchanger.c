@@ -6,6 +6,11 @@
  */
 
 #include "flipchanger.h"
+#include "flipchanger_json.h"
+#include "flipchanger_db.h"
+#include "flipchanger_sort.h"
+#include "flipchanger_facets.h"
+#include "flipchanger_worker.h"
 #include <notification/notification_messages.h>
 #include <m-array.h>
 #include <stream/stream.h>
@@ -14,524 +19,1953 @@
 #include <furi.h>
 #include <string.h>
 
+#define TAG "FlipChanger"
+
+// JSON index sidecar: header + one entry per slot (length 0 = slot not in file)
+#define FLIPCHANGER_INDEX_MAGIC 0x58494346  // "FCIX"
+#define FLIPCHANGER_INDEX_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t total_slots;
+    uint32_t source_size;   // Stamp of the JSON file the offsets belong to
+    uint32_t source_mtime;
+} FlipChangerIndexHeader;
+
+typedef struct {
+    uint32_t offset;        // Byte offset of the slot's '{'
+    uint32_t length;        // Bytes up to and including its '}'
+} FlipChangerIndexEntry;
+
+static bool flipchanger_load_slot_from_json(
+    FlipChangerApp* app,
+    int32_t slot_index,
+    Slot* slot,
+    TrackList* tracks);
+
+// Clear the cache (entries are dropped, not written back)
+static void flipchanger_reset_cache(FlipChangerApp* app) {
+    for(int32_t i = 0; i < SLOT_CACHE_SIZE; i++) {
+        app->cache[i].slot_index = -1;
+        app->cache[i].last_used = 0;
+        app->cache[i].dirty = false;
+        app->cache[i].loading = false;
+    }
+}
+
+// Helper: Free cached slot bodies (exit only - after the storage worker has stopped)
+static void flipchanger_free_cache(FlipChangerApp* app) {
+    for(int32_t i = 0; i < SLOT_CACHE_SIZE; i++) {
+        free(app->cache[i].slot);
+        app->cache[i].slot = NULL;
+        app->cache[i].slot_index = -1;
+    }
+}
+
 // Initialize slots (only cache in memory, full data on SD card)
 void flipchanger_init_slots(FlipChangerApp* app, int32_t total_slots) {
     app->total_slots = (total_slots < MIN_SLOTS) ? MIN_SLOTS : 
                        (total_slots > MAX_SLOTS) ? MAX_SLOTS : total_slots;
     
-    // Only initialize cache slots (memory efficient)
-    for(int32_t i = 0; i < SLOT_CACHE_SIZE; i++) {
-        app->slots[i].slot_number = i + 1;
-        app->slots[i].occupied = false;
-        memset(&app->slots[i].cd, 0, sizeof(CD));
-        app->slots[i].cd.track_count = 0;
-    }
+    // Cache fills on demand (memory efficient)
+    flipchanger_reset_cache(app);
     
-    app->cache_start_index = 0;
     app->current_slot_index = 0;
     app->selected_index = 0;
     app->scroll_offset = 0;
 }
 
-// Load slot from SD card into cache
-bool flipchanger_load_slot_from_sd(FlipChangerApp* app, int32_t slot_index) {
-    // For now, just reload all data (inefficient but works)
-    // TODO: Optimize to load individual slot
-    if(slot_index < 0 || slot_index >= app->total_slots) {
+// Helper: Find a slot's cache entry, loaded or not (NULL if not resident)
+static SlotCacheEntry* flipchanger_cache_find(FlipChangerApp* app, int32_t slot_index) {
+    for(int32_t i = 0; i < SLOT_CACHE_SIZE; i++) {
+        if(app->cache[i].slot_index == slot_index) {
+            return &app->cache[i];
+        }
+    }
+    return NULL;
+}
+
+// Helper: Queue save of a copy of the slot - false if the storage queue stayed full
+static bool flipchanger_post_save(
+    FlipChangerApp* app,
+    int32_t slot_index,
+    const Slot* slot,
+    uint32_t timeout) {
+    StorageRequest request = {
+        .type = StorageRequestSave,
+        .slot_index = slot_index,
+        .slot = malloc(sizeof(Slot)),
+    };
+    memcpy(request.slot, slot, sizeof(Slot));
+    if(!flipchanger_worker_post(app->worker, &request, timeout)) {
+        free(request.slot);
         return false;
     }
-    
-    // Reload entire file and find slot
-    // This is inefficient but safe - can optimize later
-    return flipchanger_load_data(app);
+    return true;
 }
 
-// Save slot to SD card
-bool flipchanger_save_slot_to_sd(FlipChangerApp* app, int32_t slot_index) {
-    // For now, save all cached slots (efficient enough for our use case)
-    // TODO: Optimize to update single slot in file
-    if(slot_index < 0 || slot_index >= app->total_slots) {
+// Helper: Queue save of a cache entry if it has unsaved changes
+static bool flipchanger_cache_write_back(
+    FlipChangerApp* app,
+    SlotCacheEntry* entry,
+    uint32_t timeout) {
+    if(!entry->dirty) {
+        return true;
+    }
+    if(!flipchanger_post_save(app, entry->slot_index, entry->slot, timeout)) {
         return false;
     }
-    
-    // Save all cached slots to file
-    return flipchanger_save_data(app);
+    entry->dirty = false;
+    return true;
 }
 
-// Get slot from cache or SD card
-Slot* flipchanger_get_slot(FlipChangerApp* app, int32_t slot_index) {
-    if(slot_index < 0 || slot_index >= app->total_slots) {
-        return NULL;
+// Helper: Free an entry - an unused one, else the least recently used that is not still
+// loading (its unsaved changes are queued first). NULL if none can be freed right now
+static SlotCacheEntry* flipchanger_cache_evict(FlipChangerApp* app) {
+    SlotCacheEntry* victim = NULL;
+    for(int32_t i = 0; i < SLOT_CACHE_SIZE; i++) {
+        SlotCacheEntry* entry = &app->cache[i];
+        if(entry->slot_index < 0) {
+            return entry;
+        }
+        if(!entry->loading && (!victim || entry->last_used < victim->last_used)) {
+            victim = entry;
+        }
     }
-    
-    // Check if slot is in cache
-    int32_t cache_index = slot_index - app->cache_start_index;
-    if(cache_index >= 0 && cache_index < SLOT_CACHE_SIZE) {
-        return &app->slots[cache_index];
+    if(!victim || !flipchanger_cache_write_back(app, victim, 0)) {
+        return NULL;
     }
-    
-    // Slot not in cache - try to load from SD card
-    // For now, return NULL (will implement SD loading)
-    // TODO: Load slot from SD card and update cache
-    return NULL;
+    victim->slot_index = -1;
+    return victim;
 }
 
-// Update cache to include requested slot (only call from input handler, not draw!)
-void flipchanger_update_cache(FlipChangerApp* app, int32_t slot_index) {
-    // Calculate new cache start
-    int32_t new_cache_start = slot_index - (SLOT_CACHE_SIZE / 2);
-    if(new_cache_start < 0) {
-        new_cache_start = 0;
+// Helper: Reserve an entry for a slot - empty slots are filled in place, the rest are
+// queued to the storage worker (no SD access here). False if the storage queue is full
+static bool flipchanger_cache_fetch(FlipChangerApp* app, int32_t slot_index) {
+    SlotCacheEntry* entry = flipchanger_cache_evict(app);
+    if(!entry) {
+        return false;
     }
-    if(new_cache_start + SLOT_CACHE_SIZE > app->total_slots) {
-        new_cache_start = app->total_slots - SLOT_CACHE_SIZE;
-        if(new_cache_start < 0) {
-            new_cache_start = 0;
+    
+    // Empty per the occupancy bitmap - nothing to read
+    bool empty = flipchanger_db_is_open(app->db) && !flipchanger_db_is_occupied(app->db, slot_index);
+    if(!empty) {
+        StorageRequest request = {.type = StorageRequestLoad, .slot_index = slot_index};
+        if(!flipchanger_worker_post(app->worker, &request, 0)) {
+            return false;  // Entry stays free
         }
     }
     
-    // Only reload if cache needs to shift
-    if(new_cache_start != app->cache_start_index) {
-        // Save current cache if dirty (before reloading)
-        if(app->dirty && app->storage) {
-            flipchanger_save_data(app);
-        }
-        
-        // Reload data from SD card (this loads cached slots)
-        // TODO: Optimize to load only the new cache range
-        if(app->storage) {
-            flipchanger_load_data(app);
-        }
-        app->cache_start_index = new_cache_start;
-        
-        // Update slot numbers in cache
-        for(int32_t i = 0; i < SLOT_CACHE_SIZE && i < app->total_slots; i++) {
-            app->slots[i].slot_number = app->cache_start_index + i + 1;
-        }
+    // Worker fills it under app->mutex, which the caller holds until we are done here
+    if(app->slot_read_failed == slot_index) {
+        app->slot_read_failed = -1;  // Trying again
+    }
+    entry->slot_index = slot_index;
+    entry->last_used = ++app->cache_clock;
+    entry->dirty = false;
+    entry->loading = !empty;
+    if(!entry->slot) {
+        entry->slot = malloc(sizeof(Slot));
     }
+    memset(entry->slot, 0, sizeof(Slot));
+    entry->slot->slot_number = slot_index + 1;
+    return true;
 }
 
-// Get slot status string (from cache or SD)
-const char* flipchanger_get_slot_status(FlipChangerApp* app, int32_t slot_index) {
-    Slot* slot = flipchanger_get_slot(app, slot_index);
-    if(!slot) {
-        // Not in cache, try to load
-        flipchanger_load_slot_from_sd(app, slot_index);
-        slot = flipchanger_get_slot(app, slot_index);
-        if(!slot) {
-            return "Empty";  // Default to empty if can't load
-        }
+// Read one slot from the card (storage worker) - database record, or the JSON through its index
+bool flipchanger_read_slot(FlipChangerApp* app, int32_t slot_index, Slot* slot) {
+    if(slot_index < 0 || slot_index >= app->total_slots) {
+        return false;
     }
     
-    if(slot->occupied) {
-        return slot->cd.album;
+    if(!flipchanger_db_is_open(app->db)) {
+        // No database (e.g. card full) - seek into the JSON through the index
+        return flipchanger_load_slot_from_json(app, slot_index, slot, NULL);
     }
     
-    return "Empty";
+    return flipchanger_db_read_slot(app->db, slot_index, slot);
 }
 
-// Count occupied slots (counts cached slots only - full count from SD card later)
-int32_t flipchanger_count_occupied_slots(FlipChangerApp* app) {
-    int32_t count = 0;
-    // Only count cached slots for now
-    // TODO: Count all slots from SD card
-    for(int32_t i = 0; i < SLOT_CACHE_SIZE && i < app->total_slots; i++) {
-        if(app->slots[i].occupied) {
-            count++;
+// Hand a loaded slot to its reserved cache entry (storage worker)
+// A failed read frees the entry instead - its zeroed body would pass for an empty slot
+void flipchanger_install_slot(FlipChangerApp* app, int32_t slot_index, const Slot* slot) {
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    SlotCacheEntry* entry = flipchanger_cache_find(app, slot_index);
+    if(entry && entry->loading) {
+        if(slot) {
+            *entry->slot = *slot;
+        } else {
+            entry->slot_index = -1;
+            app->slot_read_failed = slot_index;
         }
+        entry->loading = false;
+        app->view_generation++;
     }
-    return count;
+    furi_mutex_release(app->mutex);
 }
 
-// Helper: Skip whitespace in JSON
-static const char* skip_whitespace(const char* str) {
-    while(*str == ' ' || *str == '\t' || *str == '\n' || *str == '\r') {
-        str++;
+// Helper: A saved slot may match any query now - put it back into every level (storage worker)
+static void flipchanger_search_session_add(FlipChangerApp* app, int32_t slot_index) {
+    SearchSession* session = app->search_session;
+    if(!session) {
+        return;
+    }
+    for(int32_t level = 0; level < SEARCH_LEVELS; level++) {
+        session->text[level][slot_index / 32] |= 1u << (slot_index % 32);
+        session->tracks[level][slot_index / 32] |= 1u << (slot_index % 32);
     }
-    return str;
 }
 
-// Helper: Read string value from JSON
-static const char* read_json_string(const char* json, char* buffer, size_t buffer_size) {
-    const char* p = skip_whitespace(json);
-    if(*p != '"') return NULL;
-    p++;  // Skip opening quote
-    
-    size_t i = 0;
-    while(*p && *p != '"' && i < buffer_size - 1) {
-        if(*p == '\\' && *(p + 1) == '"') {
-            buffer[i++] = '"';
-            p += 2;
-        } else {
-            buffer[i++] = *p++;
+// Journal one slot (storage worker) - its summary is updated once it is on the card
+// A summary the string table has no room for fails the save too - the journal copy keeps
+// the names and compaction leaves it there until a retry gets them in
+bool flipchanger_write_slot(FlipChangerApp* app, int32_t slot_index, const Slot* slot) {
+    bool journaled = flipchanger_db_journal_slot(app->db, slot_index, slot);
+    
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    bool result = journaled && flipchanger_db_update_summary(app->db, slot_index, slot);
+    if(result) {
+        app->view_generation++;
+    } else {
+        // Keep the edit if the slot is still cached - it goes out again on eviction or exit
+        FURI_LOG_E(TAG, "Failed to save slot %ld", (long)(slot_index + 1));
+        SlotCacheEntry* entry = flipchanger_cache_find(app, slot_index);
+        if(entry && !entry->loading) {
+            entry->dirty = true;
+            app->dirty = true;
         }
     }
-    buffer[i] = '\0';
+    furi_mutex_release(app->mutex);
+    
+    if(result) {
+        flipchanger_search_session_add(app, slot_index);
+        app->export_pending = true;
+    }
     
-    if(*p == '"') p++;  // Skip closing quote
-    return p;
+    // Fold the journal back into the records once it gets large (or the string table fills -
+    // that frees the names nothing uses any more, so a failed save fits when it is retried)
+    if(journaled && flipchanger_db_needs_compact(app->db)) {
+        flipchanger_db_compact(app->db);
+    }
+    return result;
 }
 
-// Helper: Read integer value from JSON
-static const char* read_json_int(const char* json, int32_t* value) {
-    const char* p = skip_whitespace(json);
-    *value = 0;
-    bool negative = false;
-    
-    if(*p == '-') {
-        negative = true;
-        p++;
+// Read one slot's track list (storage worker) - from the tracks file, or the JSON
+bool flipchanger_read_tracks(FlipChangerApp* app, int32_t slot_index, TrackList* tracks) {
+    if(slot_index < 0 || slot_index >= app->total_slots) {
+        return false;
     }
     
-    while(*p >= '0' && *p <= '9') {
-        *value = *value * 10 + (*p - '0');
-        p++;
+    if(!flipchanger_db_is_open(app->db)) {
+        Slot* scratch = malloc(sizeof(Slot));
+        bool result = flipchanger_load_slot_from_json(app, slot_index, scratch, tracks);
+        free(scratch);
+        return result;
     }
     
-    if(negative) *value = -(*value);
-    return p;
+    return flipchanger_db_read_tracks(app->db, slot_index, tracks);
 }
 
-// Helper: Read boolean value from JSON
-static const char* read_json_bool(const char* json, bool* value) {
-    const char* p = skip_whitespace(json);
-    if(strncmp(p, "true", 4) == 0) {
-        *value = true;
-        return p + 4;
-    } else if(strncmp(p, "false", 5) == 0) {
-        *value = false;
-        return p + 5;
+// Hand a loaded track list to the track view, if it is still waiting for it (storage worker)
+// A failed read leaves the list loading - an empty one would save over the stored tracks
+void flipchanger_install_tracks(FlipChangerApp* app, int32_t slot_index, const TrackList* tracks) {
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    if(app->tracks && app->tracks_loading && app->tracks_slot_index == slot_index) {
+        if(tracks) {
+            track_list_copy(app->tracks, tracks);
+            app->tracks_loading = false;
+        } else {
+            app->tracks_failed = true;
+        }
+        app->view_generation++;
     }
-    return NULL;
+    furi_mutex_release(app->mutex);
 }
 
-// Helper: Find JSON key
-static const char* find_json_key(const char* json, const char* key) {
-    char key_pattern[64];
-    snprintf(key_pattern, sizeof(key_pattern), "\"%s\"", key);
-    const char* found = strstr(json, key_pattern);
-    if(!found) return NULL;
+// Journal one track list (storage worker)
+bool flipchanger_write_tracks(FlipChangerApp* app, int32_t slot_index, const TrackList* tracks) {
+    if(!flipchanger_db_journal_tracks(app->db, slot_index, tracks)) {
+        // Keep the edit if the list is still open - it goes out again when the view closes
+        FURI_LOG_E(TAG, "Failed to save tracks of slot %ld", (long)(slot_index + 1));
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        if(app->tracks && !app->tracks_loading && app->tracks_slot_index == slot_index) {
+            app->tracks_dirty = true;
+        }
+        furi_mutex_release(app->mutex);
+        return false;
+    }
+    
+    // Playing time of the disc moves the collection totals
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    flipchanger_db_update_length(app->db, slot_index, track_list_total_duration(tracks));
+    app->view_generation++;
+    furi_mutex_release(app->mutex);
+    flipchanger_search_session_add(app, slot_index);
+    app->export_pending = true;
     
-    const char* p = found + strlen(key_pattern);
-    p = skip_whitespace(p);
-    if(*p == ':') {
-        return p + 1;
+    if(flipchanger_db_needs_compact(app->db)) {
+        flipchanger_db_compact(app->db);
     }
-    return NULL;
+    return true;
 }
 
-// Load data from JSON file
-bool flipchanger_load_data(FlipChangerApp* app) {
-    if(!app || !app->storage) {
-        return false;
+// Helper: Search session for query - levels of prefixes it does not share are dropped
+static SearchSession* flipchanger_search_session(FlipChangerApp* app, const char* query) {
+    if(!app->search_session) {
+        app->search_session = malloc(sizeof(SearchSession));
+        memset(app->search_session, 0, sizeof(SearchSession));
     }
+    SearchSession* session = app->search_session;
     
-    // Initialize with default slots
-    flipchanger_init_slots(app, DEFAULT_SLOTS);
-    
-    // Try to open and read file if it exists
-    File* file = storage_file_alloc(app->storage);
-    
-    if(!storage_file_open(file, FLIPCHANGER_DATA_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        // File doesn't exist - use defaults
-        storage_file_free(file);
-        return true;
+    size_t common = 0;
+    while(session->query[common] && session->query[common] == query[common]) {
+        common++;
     }
-    
-    // Read file into buffer (must fit in stack - reduced to 2KB)
-    uint8_t buffer[2048];  // 2KB buffer - fits in stack, read incrementally if needed
-    uint16_t bytes_read = storage_file_read(file, buffer, sizeof(buffer) - 1);
-    if(bytes_read >= sizeof(buffer) - 1) {
-        // File too large - truncate and warn (shouldn't happen with reasonable data)
-        bytes_read = sizeof(buffer) - 1;
+    if(common < SEARCH_MIN_QUERY) {
+        session->levels = 0;
+    } else {
+        session->levels &= (1u << (common - SEARCH_MIN_QUERY + 1)) - 1;
+    }
+    strncpy(session->query, query, SEARCH_QUERY_LENGTH - 1);
+    session->query[SEARCH_QUERY_LENGTH - 1] = '\0';
+    return session;
+}
+
+// Helper: Whole album of a slot - the summary unless it may have been cut short (NULL if unread)
+static const char* flipchanger_search_album(
+    FlipChangerApp* app,
+    int32_t slot_index,
+    const SlotSummary* summary,
+    Slot** slot) {
+    if(strlen(summary->album) < SUMMARY_TEXT_LENGTH - 1) {
+        return summary->album;
+    }
+    if(!*slot) {
+        *slot = malloc(sizeof(Slot));
+    }
+    return flipchanger_read_slot(app, slot_index, *slot) ? (*slot)->cd.album : NULL;
+}
+
+// Search every slot for query (storage worker). The candidates are the slots that may match
+// the longest shorter query already searched, narrowed by the signatures - the same query again
+// (after DEL) reuses its level as is. Artist and album are checked in RAM; only candidates for a
+// track match (or a long album) are read. Candidates left unchecked once the results are full
+// stay in the level, so it always holds every slot that can match
+bool flipchanger_search(FlipChangerApp* app, const char* query, SearchResults* results) {
+    memset(results, 0, sizeof(SearchResults));
+    int32_t level = (int32_t)strlen(query) - SEARCH_MIN_QUERY;
+    if(level < 0 || level >= SEARCH_LEVELS) {
+        return false;
     }
-    buffer[bytes_read] = '\0';
-    
-    storage_file_close(file);
-    storage_file_free(file);
-    
-    // Parse JSON
-    const char* json = (const char*)buffer;
-    const char* p = json;
     
-    // Find version (optional)
-    p = find_json_key(json, "version");
-    if(p) {
-        int32_t version = 0;
-        p = read_json_int(p, &version);
-        // Version handling (for future compatibility)
+    // Typed over already - its results would be dropped anyway
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    bool current = strcmp(app->search_query, query) == 0;
+    furi_mutex_release(app->mutex);
+    if(!current) {
+        return true;
     }
     
-    // Find total_slots
-    p = find_json_key(json, "total_slots");
-    if(p) {
-        int32_t total_slots = DEFAULT_SLOTS;
-        p = read_json_int(p, &total_slots);
-        if(total_slots >= MIN_SLOTS && total_slots <= MAX_SLOTS) {
-            app->total_slots = total_slots;
+    SearchSession* session = flipchanger_search_session(app, query);
+    uint32_t text[SLOT_BITMAP_WORDS];
+    uint32_t tracks[SLOT_BITMAP_WORDS];
+    int32_t from = level;
+    while(from >= 0 && !((session->levels >> from) & 1u)) {
+        from--;
+    }
+    if(from >= 0) {
+        memcpy(text, session->text[from], sizeof(text));
+        memcpy(tracks, session->tracks[from], sizeof(tracks));
+    } else {
+        memset(text, 0, sizeof(text));
+        memset(tracks, 0, sizeof(tracks));
+        for(int32_t i = 0; i < app->total_slots; i++) {
+            if(flipchanger_is_occupied(app, i)) {
+                text[i / 32] |= 1u << (i % 32);
+                tracks[i / 32] |= 1u << (i % 32);
+            }
         }
     }
     
-    // Find slots array
-    p = find_json_key(json, "slots");
-    if(!p) {
-        // No slots array - use defaults
-        return true;
+    // A few candidates are cheaper to check than the signature file is to scan
+    int32_t candidates = 0;
+    for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+        candidates += __builtin_popcount(text[w] | tracks[w]);
     }
-    
-    p = skip_whitespace(p);
-    if(*p != '[') {
-        return true;  // Invalid format
+    uint32_t signed_text[SLOT_BITMAP_WORDS];
+    uint32_t signed_tracks[SLOT_BITMAP_WORDS];
+    if(from < level && candidates > SEARCH_SCAN_MIN_CANDIDATES &&
+       flipchanger_db_search(app->db, query, signed_text, signed_tracks)) {
+        for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+            text[w] &= signed_text[w];
+            tracks[w] &= signed_tracks[w];
+        }
     }
-    p++;  // Skip '['
     
-    // Parse slots (limited to what we can cache)
-    int32_t slot_index = 0;
-    while(*p && slot_index < SLOT_CACHE_SIZE && slot_index < app->total_slots) {
-        p = skip_whitespace(p);
-        if(*p == ']') break;  // End of array
-        if(*p != '{') {
-            p++;
-            continue;  // Skip invalid entry
+    Slot* slot = NULL;
+    TrackList* list = track_list_alloc();
+    bool result = true;
+    for(int32_t i = 0; i < app->total_slots && !results->more; i++) {
+        uint32_t bit = 1u << (i % 32);
+        bool in_text = text[i / 32] & bit;
+        bool in_tracks = tracks[i / 32] & bit;
+        if(!in_text && !in_tracks) {
+            continue;
         }
-        p++;  // Skip '{'
-        
-        Slot* slot = &app->slots[slot_index];
-        slot->slot_number = slot_index + 1;
-        slot->occupied = false;
-        memset(&slot->cd, 0, sizeof(CD));
-        slot->cd.track_count = 0;
-        
-        // Parse slot number
-        const char* slot_key = find_json_key(p, "slot");
-        if(slot_key) {
-            int32_t slot_num = 0;
-            read_json_int(slot_key, &slot_num);
-            slot->slot_number = slot_num;
+        const SlotSummary* summary = flipchanger_get_summary(app, i);
+        if(!summary || !flipchanger_is_occupied(app, i)) {
+            text[i / 32] &= ~bit;
+            tracks[i / 32] &= ~bit;
+            continue;
         }
         
-        // Parse occupied
-        const char* occ_key = find_json_key(p, "occupied");
-        if(occ_key) {
-            read_json_bool(occ_key, &slot->occupied);
+        if(in_text) {
+            const char* artist = flipchanger_get_string(app, summary->artist);
+            const char* album = NULL;
+            if(search_text_matches(artist, query)) {
+                search_results_add(results, i, SEARCH_NO_TRACK, artist);
+            } else if((album = flipchanger_search_album(app, i, summary, &slot)) == NULL) {
+                result = false;  // Unread - stays a candidate
+            } else if(search_text_matches(album, query)) {
+                search_results_add(results, i, SEARCH_NO_TRACK, album);
+            } else {
+                text[i / 32] &= ~bit;
+            }
         }
         
-        if(slot->occupied) {
-            // Parse artist
-            const char* artist_key = find_json_key(p, "artist");
-            if(artist_key) {
-                read_json_string(artist_key, slot->cd.artist, MAX_ARTIST_LENGTH);
-            }
-            
-            // Parse album
-            const char* album_key = find_json_key(p, "album");
-            if(album_key) {
-                read_json_string(album_key, slot->cd.album, MAX_ALBUM_LENGTH);
-            }
-            
-            // Parse year
-            const char* year_key = find_json_key(p, "year");
-            if(year_key) {
-                read_json_int(year_key, &slot->cd.year);
-            }
-            
-            // Parse genre
-            const char* genre_key = find_json_key(p, "genre");
-            if(genre_key) {
-                read_json_string(genre_key, slot->cd.genre, MAX_GENRE_LENGTH);
-            }
-            
-            // Parse tracks array (simplified - just count for now)
-            const char* tracks_key = find_json_key(p, "tracks");
-            if(tracks_key) {
-                const char* tracks_start = skip_whitespace(tracks_key);
-                if(*tracks_start == '[') {
-                    tracks_start++;
-                    int32_t track_count = 0;
-                    const char* track_p = tracks_start;
-                    
-                    // Count tracks
-                    while(*track_p && track_count < MAX_TRACKS) {
-                        track_p = skip_whitespace(track_p);
-                        if(*track_p == ']') break;
-                        if(*track_p == '{') {
-                            // Parse track (simplified)
-                            track_count++;
-                            while(*track_p && *track_p != '}') track_p++;
-                            if(*track_p == '}') track_p++;
-                        } else {
-                            track_p++;
+        // A list left behind by a cleared CD is past the slot's track count
+        if(in_tracks) {
+            bool matched = false;
+            if(summary->track_count > 0) {
+                if(!flipchanger_read_tracks(app, i, list)) {
+                    result = false;
+                    continue;
+                }
+                for(int32_t t = 0; t < summary->track_count && t < list->count; t++) {
+                    const char* title = track_list_title(list, t);
+                    if(search_text_matches(title, query)) {
+                        matched = true;
+                        if(!search_results_add(results, i, t, title)) {
+                            break;
                         }
-                        if(*track_p == ',') track_p++;
                     }
-                    slot->cd.track_count = track_count;
                 }
             }
-            
-            // Parse notes
-            const char* notes_key = find_json_key(p, "notes");
-            if(notes_key) {
-                read_json_string(notes_key, slot->cd.notes, MAX_NOTES_LENGTH);
+            if(!matched) {
+                tracks[i / 32] &= ~bit;
             }
         }
+    }
+    track_list_free(list);
+    free(slot);
+    
+    memcpy(session->text[level], text, sizeof(text));
+    memcpy(session->tracks[level], tracks, sizeof(tracks));
+    session->levels |= 1u << level;
+    return result;
+}
+
+// Hand search results to the search view, if it still shows that query (storage worker)
+void flipchanger_install_search(FlipChangerApp* app, const char* query, const SearchResults* results) {
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    if(app->search_results && app->search_running && strcmp(app->search_query, query) == 0) {
+        *app->search_results = *results;
+        app->search_running = false;
+        app->view_generation++;
+    }
+    furi_mutex_release(app->mutex);
+}
+
+// Queue saves of every modified cached slot
+static bool flipchanger_write_back_cache(FlipChangerApp* app, uint32_t timeout) {
+    bool result = true;
+    for(int32_t i = 0; i < SLOT_CACHE_SIZE; i++) {
+        if(app->cache[i].slot_index >= 0 && !app->cache[i].loading) {
+            result &= flipchanger_cache_write_back(app, &app->cache[i], timeout);
+        }
+    }
+    if(result) {
+        app->dirty = false;
+    }
+    return result;
+}
+
+// Save slot - queues one journal append on the storage worker, JSON export is deferred to exit
+bool flipchanger_save_slot_to_sd(FlipChangerApp* app, int32_t slot_index) {
+    if(slot_index < 0 || slot_index >= app->total_slots) {
+        return false;
+    }
+    
+    SlotCacheEntry* entry = flipchanger_cache_find(app, slot_index);
+    if(!entry || entry->loading) {
+        return false;
+    }
+    
+    // Queue full - stays dirty and goes out on eviction or exit instead
+    entry->dirty = true;
+    return flipchanger_cache_write_back(app, entry, 0);
+}
+
+// Get slot from cache (NULL if not resident or still loading - safe from draw)
+Slot* flipchanger_get_slot(FlipChangerApp* app, int32_t slot_index) {
+    if(slot_index < 0 || slot_index >= app->total_slots) {
+        return NULL;
+    }
+    
+    SlotCacheEntry* entry = flipchanger_cache_find(app, slot_index);
+    return (entry && !entry->loading) ? entry->slot : NULL;
+}
+
+// Placeholder for a slot get_slot has no body for - still loading, or its read failed
+const char* flipchanger_slot_placeholder(FlipChangerApp* app, int32_t slot_index) {
+    return app->slot_read_failed == slot_index ? "Read error" : "Loading...";
+}
+
+// Make slot resident, evicting the least recently used one (only call from input handler, not draw!)
+// A miss queues the load - views show a placeholder until the worker reports back
+void flipchanger_update_cache(FlipChangerApp* app, int32_t slot_index) {
+    if(slot_index < 0 || slot_index >= app->total_slots) {
+        return;
+    }
+    
+    SlotCacheEntry* entry = flipchanger_cache_find(app, slot_index);
+    if(entry) {
+        app->cache_hits++;
+        entry->last_used = ++app->cache_clock;
+        return;
+    }
+    
+    // Storage queue full - retried when the next request completes
+    app->cache_misses++;
+    flipchanger_cache_fetch(app, slot_index);
+}
+
+// Queue prefetch of the slots ahead of the selection (the storage worker loads them)
+// Rapid or held moves look further ahead so the cache stays in front of the cursor
+static void flipchanger_request_prefetch(FlipChangerApp* app, int32_t direction, bool held) {
+    uint32_t now = furi_get_tick();
+    bool rapid = held || (direction == app->scroll_direction &&
+                          now - app->last_scroll_tick < furi_ms_to_ticks(PREFETCH_FAST_MS));
+    app->scroll_direction = direction;
+    app->last_scroll_tick = now;
+    
+    // Rows ahead in the list order - the slots behind them need not be adjacent
+    int32_t count = rapid ? PREFETCH_FAST_PAGE : PREFETCH_PAGE;
+    int32_t row = app->selected_index;
+    for(int32_t i = 0; i < count; i++) {
+        row += direction;
+        int32_t slot_index = flipchanger_list_slot(app, row);
+        if(slot_index < 0) {
+            break;
+        }
         
-        // Find next slot or end of array
-        while(*p && *p != '}' && *p != ']') p++;
-        if(*p == '}') p++;  // Skip '}'
-        if(*p == ',') p++;  // Skip ','
+        // Resident (or on its way) - keep it ahead of the eviction order
+        SlotCacheEntry* entry = flipchanger_cache_find(app, slot_index);
+        if(entry) {
+            entry->last_used = ++app->cache_clock;
+            continue;
+        }
         
-        slot_index++;
+        // Empty slots open without a read anyway
+        if(!flipchanger_is_occupied(app, slot_index)) {
+            continue;
+        }
+        if(!flipchanger_cache_fetch(app, slot_index)) {
+            break;  // Storage queue full - the next move tries again
+        }
     }
-    
+}
+
+// Track list of the current slot, NULL while none is loaded for it (safe from draw)
+TrackList* flipchanger_get_tracks(FlipChangerApp* app) {
+    if(!app->tracks || app->tracks_loading || app->tracks_slot_index != app->current_slot_index) {
+        return NULL;
+    }
+    return app->tracks;
+}
+
+// Mark the open track list as modified (saved when the track view closes)
+void flipchanger_mark_tracks_dirty(FlipChangerApp* app) {
+    if(app->tracks && !app->tracks_loading) {
+        app->tracks_dirty = true;
+    }
+}
+
+// Helper: Queue save of the open track list if it changed - false if the storage queue is full
+static bool flipchanger_tracks_write_back(FlipChangerApp* app, uint32_t timeout) {
+    if(!app->tracks || !app->tracks_dirty) {
+        return true;
+    }
+    StorageRequest request = {
+        .type = StorageRequestSaveTracks,
+        .slot_index = app->tracks_slot_index,
+        .tracks = track_list_alloc(),
+    };
+    track_list_copy(request.tracks, app->tracks);
+    if(!flipchanger_worker_post(app->worker, &request, timeout)) {
+        track_list_free(request.tracks);
+        return false;
+    }
+    app->tracks_dirty = false;
     return true;
 }
 
-// Helper: Write JSON string (escape quotes)
-static void write_json_string(File* file, const char* str) {
-    if(!str || strlen(str) == 0) {
-        storage_file_write(file, (const uint8_t*)"\"\"", 2);
+// Helper: Keep the track list in step with the view (after every event) - it is loaded when
+// the track view opens and saved (if changed) and freed when it closes. Anything the full
+// storage queue refused is retried after the next event
+static void flipchanger_sync_tracks(FlipChangerApp* app) {
+    bool wanted = app->current_view == VIEW_TRACK_MANAGEMENT;
+    if(app->tracks && (!wanted || app->tracks_slot_index != app->current_slot_index)) {
+        if(!flipchanger_tracks_write_back(app, 0)) {
+            return;
+        }
+        track_list_free(app->tracks);
+        app->tracks = NULL;
+        app->tracks_slot_index = -1;
+    }
+    if(!wanted) {
+        return;
+    }
+    
+    if(!app->tracks) {
+        const Slot* slot = flipchanger_get_slot(app, app->current_slot_index);
+        if(!slot) {
+            return;  // Slot itself is still loading
+        }
+        app->tracks = track_list_alloc();
+        app->tracks_slot_index = app->current_slot_index;
+        app->tracks_dirty = false;
+        app->tracks_requested = false;
+        app->tracks_failed = false;
+        
+        // Nothing stored for a CD without tracks (or one that is being added)
+        app->tracks_loading = slot->occupied && slot->cd.track_count > 0;
+    }
+    
+    if(app->tracks_loading && !app->tracks_requested) {
+        StorageRequest request = {.type = StorageRequestLoadTracks, .slot_index = app->tracks_slot_index};
+        app->tracks_requested = flipchanger_worker_post(app->worker, &request, 0);
+    }
+}
+
+// Helper: Keep search results in step with the view (after every event) - they live while the
+// search view, or a slot opened from it, is on screen. A changed query is searched again once
+// it is long enough; a search the full storage queue refused is retried after the next event
+static void flipchanger_sync_search(FlipChangerApp* app) {
+    bool wanted = app->current_view == VIEW_SEARCH ||
+                  (app->current_view == VIEW_SLOT_DETAILS && app->details_from_search);
+    if(!wanted) {
+        free(app->search_results);
+        app->search_results = NULL;
+        app->details_from_search = false;
         return;
     }
     
-    storage_file_write(file, (const uint8_t*)"\"", 1);
+    if(!app->search_results) {
+        app->search_results = malloc(sizeof(SearchResults));
+        memset(app->search_results, 0, sizeof(SearchResults));
+    }
+    
+    if(app->search_stale && strlen(app->search_query) >= SEARCH_MIN_QUERY) {
+        StorageRequest request = {
+            .type = StorageRequestSearch,
+            .slot_index = -1,
+            .query = strdup(app->search_query),
+        };
+        if(flipchanger_worker_post(app->worker, &request, 0)) {
+            app->search_stale = false;
+            app->search_running = true;
+        } else {
+            free(request.query);
+        }
+    }
+}
+
+// Helper: Query changed - a longer one keeps the shown results that still match until the
+// worker answers, a shorter one drops them (a search still running for the old query is ignored)
+static void flipchanger_search_changed(FlipChangerApp* app, bool longer) {
+    SearchResults* results = app->search_results;
+    if(results) {
+        int32_t kept = 0;
+        for(int32_t i = 0; longer && i < results->count; i++) {
+            if(search_text_matches(results->match[i].text, app->search_query)) {
+                results->match[kept++] = results->match[i];
+            }
+        }
+        results->count = kept;
+        results->more = false;
+    }
+    app->search_stale = true;
+    app->search_running = false;
+    app->search_selected = 0;
+    app->search_scroll = 0;
+}
+
+// Storage request finished - retry a load the view is still waiting for
+static void flipchanger_handle_storage_event(FlipChangerApp* app, const FlipChangerEvent* event) {
+    UNUSED(event);
+    bool needs_slot = app->current_view == VIEW_SLOT_DETAILS ||
+                      app->current_view == VIEW_ADD_EDIT_CD ||
+                      app->current_view == VIEW_TRACK_MANAGEMENT;
+    // Not after a failed read - that waits for OK (K:Retry) instead of looping on a bad card
+    if(needs_slot && app->slot_read_failed != app->current_slot_index &&
+       !flipchanger_cache_find(app, app->current_slot_index)) {
+        flipchanger_cache_fetch(app, app->current_slot_index);
+    }
+}
+
+// Helper: Hash of a record's bytes (FNV-1a) - only used to spot edits
+static uint32_t flipchanger_hash(uint32_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    for(size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Helper: Capture what the current view is drawn from
+static void flipchanger_capture_view_state(FlipChangerApp* app, FlipChangerViewState* state) {
+    memset(state, 0, sizeof(FlipChangerViewState));
+    state->view = app->current_view;
+    state->selected_index = app->selected_index;
+    state->scroll_offset = app->scroll_offset;
+    state->sort_order = app->sort_order;
+    state->current_slot_index = app->current_slot_index;
+    state->details_scroll_offset = app->details_scroll_offset;
+    state->edit_field = app->edit_field;
+    state->edit_char_pos = app->edit_char_pos;
+    state->edit_char_selection = app->edit_char_selection;
+    state->edit_field_scroll = app->edit_field_scroll;
+    state->edit_selected_track = app->edit_selected_track;
+    state->editing_track = app->editing_track;
+    state->edit_track_field = app->edit_track_field;
+    state->read_failed = app->slot_read_failed;
+    state->tracks_failed = app->tracks_failed;
+    state->generation = app->view_generation;
+    state->search_selected = app->search_selected;
+    state->search_scroll = app->search_scroll;
+    state->search_focus_results = app->search_focus_results;
+    
+    // Filter picks change the slot list and the filter view without any other state
+    uint32_t filter = flipchanger_hash(2166136261u, app->filter_genres, sizeof(app->filter_genres));
+    filter = flipchanger_hash(filter, &app->filter_decades, sizeof(app->filter_decades));
+    state->filter_hash = flipchanger_hash(filter, &app->filter_occupied, sizeof(app->filter_occupied));
+    
+    // Search results arrive with a generation bump - the query is edited in place
+    if(app->current_view == VIEW_SEARCH) {
+        state->search_hash =
+            flipchanger_hash(2166136261u, app->search_query, sizeof(app->search_query));
+    }
+    
+    // Slot views draw straight from the cached slot
+    if(app->current_view != VIEW_MAIN_MENU && app->current_view != VIEW_SLOT_LIST &&
+       app->current_view != VIEW_SEARCH) {
+        const Slot* slot = flipchanger_get_slot(app, app->current_slot_index);
+        state->slot_hash = slot ? flipchanger_hash(2166136261u, slot, sizeof(Slot)) : 0;
+    }
+    const TrackList* tracks = flipchanger_get_tracks(app);
+    if(app->current_view == VIEW_TRACK_MANAGEMENT && tracks) {
+        state->slot_hash =
+            flipchanger_hash(state->slot_hash, tracks->tracks, tracks->count * sizeof(Track));
+        state->slot_hash = flipchanger_hash(state->slot_hash, tracks->pool, tracks->pool_size);
+    }
+}
+
+// Helper: Note whether the last event changed anything on screen
+static void flipchanger_check_redraw(FlipChangerApp* app) {
+    FlipChangerViewState state;
+    flipchanger_capture_view_state(app, &state);
+    if(memcmp(&state, &app->drawn_state, sizeof(FlipChangerViewState)) != 0) {
+        app->drawn_state = state;
+        app->redraw_pending = true;
+    }
+}
+
+// Mark cached slot as modified (written back on save, eviction or exit)
+void flipchanger_mark_dirty(FlipChangerApp* app, int32_t slot_index) {
+    SlotCacheEntry* entry = flipchanger_cache_find(app, slot_index);
+    if(entry && !entry->loading) {
+        entry->dirty = true;
+        app->dirty = true;
+    }
+}
+
+// Get slot summary (resident for every slot - safe to call from draw)
+const SlotSummary* flipchanger_get_summary(FlipChangerApp* app, int32_t slot_index) {
+    if(slot_index < 0 || slot_index >= app->total_slots) {
+        return NULL;
+    }
+    return flipchanger_db_get_summary(app->db, slot_index);
+}
+
+// Artist/genre name of a summary (interned - the whole name, not a prefix)
+const char* flipchanger_get_string(FlipChangerApp* app, uint16_t id) {
+    return flipchanger_db_get_string(app->db, id);
+}
+
+// Collection totals (resident, kept up to date by every save - safe to call from draw)
+const CollectionStats* flipchanger_get_stats(FlipChangerApp* app) {
+    return flipchanger_db_get_stats(app->db);
+}
+
+// Check occupancy bit (resident for every slot)
+bool flipchanger_is_occupied(FlipChangerApp* app, int32_t slot_index) {
+    if(slot_index < 0 || slot_index >= app->total_slots) {
+        return false;
+    }
+    return flipchanger_db_is_occupied(app->db, slot_index);
+}
+
+// Get slot status string (from the summary - album may be truncated)
+const char* flipchanger_get_slot_status(FlipChangerApp* app, int32_t slot_index) {
+    const SlotSummary* summary = flipchanger_get_summary(app, slot_index);
+    if(summary && flipchanger_is_occupied(app, slot_index)) {
+        return summary->album;
+    }
     
-    const char* p = str;
-    while(*p) {
-        if(*p == '"' || *p == '\\') {
-            storage_file_write(file, (const uint8_t*)"\\", 1);
+    return "Empty";
+}
+
+bool flipchanger_filter_active(FlipChangerApp* app) {
+    if(app->filter_occupied || app->filter_decades) {
+        return true;
+    }
+    for(int32_t w = 0; w < FILTER_GENRE_WORDS; w++) {
+        if(app->filter_genres[w]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Helper: Occupied slots - every one is in exactly one decade bitset (no year included)
+static void flipchanger_filter_occupied(const FacetIndex* facets, uint32_t* bits) {
+    memset(bits, 0, SLOT_BITMAP_WORDS * sizeof(uint32_t));
+    for(int32_t decade = 0; decade < FACET_DECADES; decade++) {
+        facet_index_or_decade(facets, decade, bits);
+    }
+}
+
+void flipchanger_filter_slots(FlipChangerApp* app, uint32_t* bits) {
+    for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+        int32_t left = app->total_slots - w * 32;
+        bits[w] = left >= 32 ? 0xFFFFFFFFu : left > 0 ? (1u << left) - 1 : 0;
+    }
+    
+    const FacetIndex* facets = flipchanger_db_get_facets(app->db);
+    uint32_t facet[SLOT_BITMAP_WORDS];
+    if(app->filter_occupied) {
+        flipchanger_filter_occupied(facets, facet);
+        for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+            bits[w] &= facet[w];
+        }
+    }
+    if(app->filter_decades) {
+        memset(facet, 0, sizeof(facet));
+        for(int32_t decade = 0; decade < FACET_DECADES; decade++) {
+            if((app->filter_decades >> decade) & 1u) {
+                facet_index_or_decade(facets, decade, facet);
+            }
+        }
+        for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+            bits[w] &= facet[w];
+        }
+    }
+    
+    // Genres past the facet bitsets are looked up in the summaries
+    const SlotSummary* summaries = flipchanger_db_get_summaries(app->db);
+    bool genres = false;
+    memset(facet, 0, sizeof(facet));
+    for(int32_t w = 0; w < FILTER_GENRE_WORDS; w++) {
+        for(uint32_t picked = app->filter_genres[w]; picked; picked &= picked - 1) {
+            genres = true;
+            uint16_t id = (uint16_t)(w * 32 + __builtin_ctz(picked) + 1);
+            facet_index_or_genre(facets, id, summaries, facet);
+        }
+    }
+    if(genres) {
+        for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+            bits[w] &= facet[w];
+        }
+    }
+}
+
+// Helper: Slots the list shows - through the filter, and occupied in a sorted order (the
+// sort indexes hold nothing else). False if that is every slot in slot order
+static bool flipchanger_list_bits(FlipChangerApp* app, uint32_t* bits) {
+    if(app->sort_order == SortBySlot && !flipchanger_filter_active(app)) {
+        return false;
+    }
+    flipchanger_filter_slots(app, bits);
+    if(app->sort_order != SortBySlot) {
+        uint32_t occupied[SLOT_BITMAP_WORDS];
+        flipchanger_filter_occupied(flipchanger_db_get_facets(app->db), occupied);
+        for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+            bits[w] &= occupied[w];
+        }
+    }
+    return true;
+}
+
+// Helper: Slot at position i of the list order (before the filter), -1 past the end
+static int32_t flipchanger_list_order_slot(FlipChangerApp* app, int32_t i) {
+    if(app->sort_order == SortBySlot) {
+        return i < app->total_slots ? i : -1;
+    }
+    const SortIndexes* sort = flipchanger_db_get_sort(app->db);
+    return i < sort->count ? sort_indexes_get(sort, app->sort_order)[i] : -1;
+}
+
+// Helper: Bring the slot list rows up to date - returns the row count. Filtering and
+// ordering run once per change of what the list is built from, not once per lookup
+static int32_t flipchanger_list_update(FlipChangerApp* app) {
+    FlipChangerListKey key;
+    memset(&key, 0, sizeof(key));
+    key.generation = app->view_generation;
+    key.total_slots = app->total_slots;
+    key.sort_order = app->sort_order;
+    key.filter_occupied = app->filter_occupied;
+    key.filter_decades = app->filter_decades;
+    memcpy(key.filter_genres, app->filter_genres, sizeof(key.filter_genres));
+    if(app->list_count >= 0 && memcmp(&key, &app->list_key, sizeof(key)) == 0) {
+        return app->list_count;
+    }
+    
+    // Slots past the configured count stay indexed - they are skipped, not shown
+    uint32_t bits[SLOT_BITMAP_WORDS];
+    bool filtered = flipchanger_list_bits(app, bits);
+    int32_t count = 0;
+    int32_t slot_index;
+    for(int32_t i = 0; (slot_index = flipchanger_list_order_slot(app, i)) >= 0; i++) {
+        if(!filtered ? slot_index < app->total_slots :
+                       ((bits[slot_index / 32] >> (slot_index % 32)) & 1u)) {
+            app->list_slots[count++] = (uint8_t)slot_index;
+        }
+    }
+    app->list_key = key;
+    app->list_count = count;
+    return count;
+}
+
+int32_t flipchanger_list_count(FlipChangerApp* app) {
+    return flipchanger_list_update(app);
+}
+
+int32_t flipchanger_list_slot(FlipChangerApp* app, int32_t row) {
+    int32_t count = flipchanger_list_update(app);
+    return (row >= 0 && row < count) ? app->list_slots[row] : -1;
+}
+
+int32_t flipchanger_list_row(FlipChangerApp* app, int32_t slot_index) {
+    int32_t count = flipchanger_list_update(app);
+    for(int32_t row = 0; row < count; row++) {
+        if(app->list_slots[row] == slot_index) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+// Helper: Letter an artist is filed under in the jump index - A-Z, '#' for anything else
+static char flipchanger_artist_initial(FlipChangerApp* app, int32_t slot_index) {
+    const SlotSummary* summary = flipchanger_get_summary(app, slot_index);
+    char c = summary ? flipchanger_get_string(app, summary->artist)[0] : '\0';
+    if(c >= 'a' && c <= 'z') {
+        c = (char)(c - 'a' + 'A');
+    }
+    return (c >= 'A' && c <= 'Z') ? c : '#';
+}
+
+// Helper: First row of the next (direction 1) or previous artist initial - going back from
+// inside a letter lands on its first row. The last/first row if there is no such letter
+static int32_t flipchanger_list_initial_row(FlipChangerApp* app, int32_t direction) {
+    int32_t count = flipchanger_list_update(app);
+    const uint8_t* slots = app->list_slots;
+    int32_t row = app->selected_index;
+    if(row < 0 || row >= count) {
+        return row;
+    }
+    
+    char initial = flipchanger_artist_initial(app, slots[row]);
+    if(direction > 0) {
+        while(row < count && flipchanger_artist_initial(app, slots[row]) == initial) {
+            row++;
+        }
+        return row < count ? row : count - 1;
+    }
+    
+    // Already on the first row of a letter - go to the one before
+    if(row > 0 && flipchanger_artist_initial(app, slots[row - 1]) != initial) {
+        row--;
+        initial = flipchanger_artist_initial(app, slots[row]);
+    }
+    while(row > 0 && flipchanger_artist_initial(app, slots[row - 1]) == initial) {
+        row--;
+    }
+    return row;
+}
+
+// Helper: Move the slot list cursor straight to row (clamped) - only the slot it lands on is
+// fetched, none of the rows it passed over
+static void flipchanger_list_jump(FlipChangerApp* app, int32_t row) {
+    int32_t count = flipchanger_list_count(app);
+    if(row >= count) {
+        row = count - 1;
+    }
+    if(row < 0) {
+        row = 0;
+    }
+    app->selected_index = row;
+    if(row < app->scroll_offset || row >= app->scroll_offset + 4) {
+        app->scroll_offset = row > 3 ? row - 3 : 0;
+    }
+    
+    int32_t slot_index = flipchanger_list_slot(app, row);
+    if(flipchanger_is_occupied(app, slot_index)) {
+        flipchanger_update_cache(app, slot_index);
+    }
+}
+
+// Count occupied slots (all slots - popcount of the occupancy bitmap)
+int32_t flipchanger_count_occupied_slots(FlipChangerApp* app) {
+    return flipchanger_db_count_occupied(app->db, app->total_slots);
+}
+
+// Helper: Read integer value for the current key (numeric strings accepted)
+static bool flipchanger_json_read_int(JsonReader* reader, int32_t* value) {
+    JsonToken token = json_reader_next(reader);
+    if(token == JsonTokenNumber) {
+        *value = reader->number;
+        return true;
+    }
+    if(token == JsonTokenString) {
+        *value = atoi(reader->text);
+        return true;
+    }
+    if(token == JsonTokenObjectStart || token == JsonTokenArrayStart) {
+        return json_reader_skip_container(reader);
+    }
+    return token == JsonTokenTrue || token == JsonTokenFalse || token == JsonTokenNull;
+}
+
+// Helper: Read string value for the current key (other types are skipped)
+static bool flipchanger_json_read_string(JsonReader* reader, char* buffer, size_t buffer_size) {
+    JsonToken token = json_reader_next(reader);
+    if(token == JsonTokenString) {
+        json_reader_copy_text(reader, buffer, buffer_size);
+        return true;
+    }
+    if(token == JsonTokenObjectStart || token == JsonTokenArrayStart) {
+        return json_reader_skip_container(reader);
+    }
+    return token == JsonTokenNumber || token == JsonTokenTrue || token == JsonTokenFalse ||
+           token == JsonTokenNull;
+}
+
+// Helper: Read track duration for the current key ("m:ss" text or a number of seconds)
+static bool flipchanger_json_read_duration(JsonReader* reader, uint16_t* seconds) {
+    JsonToken token = json_reader_next(reader);
+    if(token == JsonTokenNumber) {
+        *seconds = reader->number < 0 ? 0 :
+                   reader->number > UINT16_MAX ? UINT16_MAX :
+                                                 (uint16_t)reader->number;
+        return true;
+    }
+    if(token == JsonTokenString) {
+        *seconds = track_duration_parse(reader->text);
+        return true;
+    }
+    if(token == JsonTokenObjectStart || token == JsonTokenArrayStart) {
+        return json_reader_skip_container(reader);
+    }
+    return token == JsonTokenTrue || token == JsonTokenFalse || token == JsonTokenNull;
+}
+
+// Helper: Read boolean value for the current key
+static bool flipchanger_json_read_bool(JsonReader* reader, bool* value) {
+    JsonToken token = json_reader_next(reader);
+    if(token == JsonTokenTrue || token == JsonTokenFalse) {
+        *value = (token == JsonTokenTrue);
+        return true;
+    }
+    if(token == JsonTokenObjectStart || token == JsonTokenArrayStart) {
+        return json_reader_skip_container(reader);
+    }
+    return token == JsonTokenNumber || token == JsonTokenString || token == JsonTokenNull;
+}
+
+// Helper: Read current key name into a small buffer (reader->text is reused by the value)
+static void flipchanger_json_key(JsonReader* reader, char* key, size_t key_size) {
+    json_reader_copy_text(reader, key, key_size);
+}
+
+// Parse one track object (opening '{' already consumed)
+static bool flipchanger_parse_track(
+    JsonReader* reader,
+    int32_t* number,
+    char title[MAX_TRACK_TITLE_LENGTH],
+    uint16_t* duration) {
+    char key[16];
+    while(true) {
+        JsonToken token = json_reader_next(reader);
+        if(token == JsonTokenObjectEnd) {
+            return true;
+        }
+        if(token != JsonTokenKey) {
+            return false;
+        }
+        flipchanger_json_key(reader, key, sizeof(key));
+
+        bool ok;
+        if(strcmp(key, "num") == 0) {
+            ok = flipchanger_json_read_int(reader, number);
+        } else if(strcmp(key, "title") == 0) {
+            ok = flipchanger_json_read_string(reader, title, MAX_TRACK_TITLE_LENGTH);
+        } else if(strcmp(key, "duration") == 0) {
+            ok = flipchanger_json_read_duration(reader, duration);
+        } else {
+            ok = json_reader_skip_value(reader);
+        }
+        if(!ok) {
+            return false;
+        }
+    }
+}
+
+// Parse tracks array (key already consumed) - tracks == NULL only counts them
+static bool flipchanger_parse_tracks(JsonReader* reader, CD* cd, TrackList* tracks) {
+    JsonToken token = json_reader_next(reader);
+    if(token != JsonTokenArrayStart) {
+        // Not an array - tolerate and skip
+        if(token == JsonTokenObjectStart) {
+            return json_reader_skip_container(reader);
+        }
+        return token != JsonTokenError && token != JsonTokenEnd;
+    }
+
+    cd->track_count = 0;
+    while(true) {
+        token = json_reader_next(reader);
+        if(token == JsonTokenArrayEnd) {
+            return true;
+        }
+        if(token == JsonTokenObjectStart) {
+            if(cd->track_count < MAX_TRACKS) {
+                int32_t number = cd->track_count + 1;
+                char title[MAX_TRACK_TITLE_LENGTH] = "";
+                uint16_t duration = 0;
+                if(!flipchanger_parse_track(reader, &number, title, &duration)) {
+                    return false;
+                }
+                if(tracks) {
+                    uint8_t track_number = (number >= 0 && number <= UINT8_MAX) ? (uint8_t)number : 0;
+                    track_list_append(tracks, track_number, title, duration);
+                }
+                cd->track_count++;
+            } else if(!json_reader_skip_container(reader)) {
+                // Extra tracks beyond MAX_TRACKS are dropped
+                return false;
+            }
+        } else if(token == JsonTokenArrayStart) {
+            if(!json_reader_skip_container(reader)) {
+                return false;
+            }
+        } else if(token == JsonTokenError || token == JsonTokenEnd || token == JsonTokenKey) {
+            return false;
+        }
+    }
+}
+
+// Parse one slot object (opening '{' already consumed) - tracks may be NULL
+static bool flipchanger_parse_slot(JsonReader* reader, Slot* slot, TrackList* tracks) {
+    char key[16];
+    while(true) {
+        JsonToken token = json_reader_next(reader);
+        if(token == JsonTokenObjectEnd) {
+            break;
+        }
+        if(token != JsonTokenKey) {
+            return false;
+        }
+        flipchanger_json_key(reader, key, sizeof(key));
+
+        bool ok;
+        if(strcmp(key, "slot") == 0) {
+            int32_t number = 0;
+            ok = flipchanger_json_read_int(reader, &number);
+            slot->slot_number = (number >= 1 && number <= MAX_SLOTS) ? (uint8_t)number : 0;
+        } else if(strcmp(key, "occupied") == 0) {
+            bool occupied = false;
+            ok = flipchanger_json_read_bool(reader, &occupied);
+            slot->occupied = occupied;
+        } else if(strcmp(key, "artist") == 0) {
+            ok = flipchanger_json_read_string(reader, slot->cd.artist, MAX_ARTIST_LENGTH);
+        } else if(strcmp(key, "album") == 0) {
+            ok = flipchanger_json_read_string(reader, slot->cd.album, MAX_ALBUM_LENGTH);
+        } else if(strcmp(key, "year") == 0) {
+            int32_t year = 0;
+            ok = flipchanger_json_read_int(reader, &year);
+            slot->cd.year = (year > 0 && year <= 9999) ? (uint16_t)year : 0;
+        } else if(strcmp(key, "genre") == 0) {
+            ok = flipchanger_json_read_string(reader, slot->cd.genre, MAX_GENRE_LENGTH);
+        } else if(strcmp(key, "tracks") == 0) {
+            ok = flipchanger_parse_tracks(reader, &slot->cd, tracks);
+        } else if(strcmp(key, "notes") == 0) {
+            ok = flipchanger_json_read_string(reader, slot->cd.notes, MAX_NOTES_LENGTH);
+        } else {
+            ok = json_reader_skip_value(reader);
+        }
+        if(!ok) {
+            return false;
+        }
+    }
+
+    // Empty slots carry no CD data
+    if(!slot->occupied) {
+        memset(&slot->cd, 0, sizeof(CD));
+    }
+    return true;
+}
+
+// Parse slots array (key already consumed) - every slot and track list goes to the database
+// (app == NULL only validates, tracks may then be NULL)
+static bool flipchanger_parse_slots(
+    FlipChangerApp* app,
+    JsonReader* reader,
+    Slot* scratch,
+    TrackList* tracks,
+    FlipChangerIndexEntry* index) {
+    if(json_reader_next(reader) != JsonTokenArrayStart) {
+        return false;
+    }
+
+    int32_t position = 0;
+    while(true) {
+        JsonToken token = json_reader_next(reader);
+        if(token == JsonTokenArrayEnd) {
+            return true;
+        }
+        if(token != JsonTokenObjectStart) {
+            if(token == JsonTokenArrayStart) {
+                if(!json_reader_skip_container(reader)) return false;
+                continue;
+            }
+            if(token == JsonTokenError || token == JsonTokenEnd || token == JsonTokenKey) {
+                return false;
+            }
+            continue;  // Skip invalid entry
+        }
+
+        // Parse into scratch slot - position is the fallback if "slot" key is missing
+        uint32_t start = reader->token_offset;
+        memset(scratch, 0, sizeof(Slot));
+        scratch->slot_number = position + 1;
+        if(tracks) {
+            track_list_reset(tracks);
+        }
+        if(!flipchanger_parse_slot(reader, scratch, tracks)) {
+            return false;
+        }
+        position++;
+
+        int32_t slot_index = scratch->slot_number - 1;
+        if(slot_index < 0 || slot_index >= MAX_SLOTS) {
+            continue;
+        }
+        if(index) {
+            index[slot_index].offset = start;
+            index[slot_index].length = reader->offset - start;
+        }
+        if(!app) {
+            continue;
+        }
+        if(app->db) {
+            // Summary first - it interns the names the record refers to (no record without them)
+            if(!flipchanger_db_update_summary(app->db, slot_index, scratch)) {
+                continue;
+            }
+            flipchanger_db_write_slot(app->db, slot_index, scratch);
+            if(scratch->cd.track_count > 0) {
+                flipchanger_db_write_tracks(app->db, slot_index, tracks);
+                flipchanger_db_update_length(
+                    app->db, slot_index, track_list_total_duration(tracks));
+            }
+        }
+    }
+}
+
+// Parse top-level collection object (app == NULL only validates)
+static bool flipchanger_parse_collection(
+    FlipChangerApp* app,
+    JsonReader* reader,
+    Slot* scratch,
+    TrackList* tracks,
+    FlipChangerIndexEntry* index) {
+    if(json_reader_next(reader) != JsonTokenObjectStart) {
+        return false;
+    }
+
+    char key[16];
+    while(true) {
+        JsonToken token = json_reader_next(reader);
+        if(token == JsonTokenObjectEnd) {
+            return true;
+        }
+        if(token != JsonTokenKey) {
+            return false;
+        }
+        flipchanger_json_key(reader, key, sizeof(key));
+
+        bool ok;
+        if(strcmp(key, "total_slots") == 0) {
+            int32_t total_slots = DEFAULT_SLOTS;
+            ok = flipchanger_json_read_int(reader, &total_slots);
+            if(app && total_slots >= MIN_SLOTS && total_slots <= MAX_SLOTS) {
+                app->total_slots = total_slots;
+            }
+        } else if(strcmp(key, "slots") == 0) {
+            ok = flipchanger_parse_slots(app, reader, scratch, tracks, index);
+        } else {
+            // "version" and unknown keys (version handling for future compatibility)
+            ok = json_reader_skip_value(reader);
+        }
+        if(!ok) {
+            return false;
+        }
+    }
+}
+
+// Write JSON index sidecar, stamped with the JSON file's current size/mtime
+static bool flipchanger_index_write(FlipChangerApp* app, const FlipChangerIndexEntry* index) {
+    FlipChangerIndexHeader header = {
+        .magic = FLIPCHANGER_INDEX_MAGIC,
+        .version = FLIPCHANGER_INDEX_VERSION,
+        .total_slots = (uint16_t)app->total_slots,
+    };
+    FlipChangerDbStamp stamp;
+    if(!flipchanger_db_stat_source(app->storage, FLIPCHANGER_DATA_PATH, &stamp)) {
+        return false;
+    }
+    header.source_size = stamp.size;
+    header.source_mtime = stamp.mtime;
+    
+    File* file = storage_file_alloc(app->storage);
+    bool result = storage_file_open(file, FLIPCHANGER_INDEX_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    if(result) {
+        result = storage_file_write(file, &header, sizeof(header)) == sizeof(header) &&
+                 storage_file_write(file, index, sizeof(FlipChangerIndexEntry) * MAX_SLOTS) ==
+                     sizeof(FlipChangerIndexEntry) * MAX_SLOTS;
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    return result;
+}
+
+// Look up one slot's JSON location - fails if the index is missing or stale
+static bool flipchanger_index_lookup(
+    FlipChangerApp* app,
+    int32_t slot_index,
+    FlipChangerIndexEntry* entry) {
+    FlipChangerDbStamp stamp;
+    if(!flipchanger_db_stat_source(app->storage, FLIPCHANGER_DATA_PATH, &stamp)) {
+        return false;
+    }
+    
+    File* file = storage_file_alloc(app->storage);
+    bool result = false;
+    if(storage_file_open(file, FLIPCHANGER_INDEX_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        FlipChangerIndexHeader header;
+        result = storage_file_read(file, &header, sizeof(header)) == sizeof(header) &&
+                 header.magic == FLIPCHANGER_INDEX_MAGIC &&
+                 header.version == FLIPCHANGER_INDEX_VERSION && header.source_size == stamp.size &&
+                 header.source_mtime == stamp.mtime &&
+                 storage_file_seek(
+                     file, sizeof(header) + slot_index * sizeof(FlipChangerIndexEntry), true) &&
+                 storage_file_read(file, entry, sizeof(FlipChangerIndexEntry)) ==
+                     sizeof(FlipChangerIndexEntry);
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    return result;
+}
+
+// Check that a JSON file parses to the end (a save cut short never does)
+static bool flipchanger_verify_json(FlipChangerApp* app, const char* path) {
+    Stream* stream = buffered_file_stream_alloc(app->storage);
+    bool result = false;
+    if(buffered_file_stream_open(stream, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        JsonReader* reader = malloc(sizeof(JsonReader));
+        Slot* scratch = malloc(sizeof(Slot));
+        json_reader_init(reader, stream);
+        result = flipchanger_parse_collection(NULL, reader, scratch, NULL, NULL);
+        free(scratch);
+        free(reader);
+        buffered_file_stream_close(stream);
+    }
+    stream_free(stream);
+    return result;
+}
+
+// Swap the verified temp file in - the previous data file becomes the backup
+static bool flipchanger_commit_json(FlipChangerApp* app) {
+    if(storage_common_stat(app->storage, FLIPCHANGER_DATA_PATH, NULL) == FSE_OK) {
+        storage_common_remove(app->storage, FLIPCHANGER_DATA_BAK_PATH);
+        if(storage_common_rename(app->storage, FLIPCHANGER_DATA_PATH, FLIPCHANGER_DATA_BAK_PATH) !=
+           FSE_OK) {
+            return false;
+        }
+    }
+    return storage_common_rename(app->storage, FLIPCHANGER_DATA_TMP_PATH, FLIPCHANGER_DATA_PATH) ==
+           FSE_OK;
+}
+
+// Finish or discard a save that was interrupted - a complete temp file is the newest copy
+static void flipchanger_recover_json(FlipChangerApp* app) {
+    if(storage_common_stat(app->storage, FLIPCHANGER_DATA_TMP_PATH, NULL) != FSE_OK) {
+        return;
+    }
+    if(flipchanger_verify_json(app, FLIPCHANGER_DATA_TMP_PATH)) {
+        FURI_LOG_W(TAG, "Completing interrupted save");
+        flipchanger_commit_json(app);
+    } else {
+        FURI_LOG_W(TAG, "Discarding incomplete save");
+        storage_common_remove(app->storage, FLIPCHANGER_DATA_TMP_PATH);
+    }
+}
+
+// Replace a missing or damaged data file with the backup (the backup itself is kept)
+static bool flipchanger_restore_backup(FlipChangerApp* app) {
+    if(!flipchanger_verify_json(app, FLIPCHANGER_DATA_BAK_PATH)) {
+        return false;
+    }
+    FURI_LOG_W(TAG, "Data file missing or damaged - restoring backup");
+    storage_common_remove(app->storage, FLIPCHANGER_DATA_PATH);
+    return storage_common_copy(app->storage, FLIPCHANGER_DATA_BAK_PATH, FLIPCHANGER_DATA_PATH) ==
+           FSE_OK;
+}
+
+// Import JSON file into a fresh database (streams the file - RAM use does not depend on file size)
+// The JSON index is rebuilt in the same pass
+static bool flipchanger_import_json(FlipChangerApp* app) {
+    if(!flipchanger_db_create(app->db, DEFAULT_SLOTS)) {
+        FURI_LOG_W(TAG, "No database - reading slots from JSON");
+    }
+    
+    // Try to open file if it exists
+    Stream* stream = buffered_file_stream_alloc(app->storage);
+    if(!buffered_file_stream_open(stream, FLIPCHANGER_DATA_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        // File doesn't exist - start with an empty database
+        stream_free(stream);
+        flipchanger_db_set_total_slots(app->db, app->total_slots);
+        return true;
+    }
+    
+    // Reader, scratch slot/tracks and index live on the heap (app stack is only 3KB)
+    JsonReader* reader = malloc(sizeof(JsonReader));
+    Slot* scratch = malloc(sizeof(Slot));
+    TrackList* tracks = track_list_alloc();
+    FlipChangerIndexEntry* index = malloc(sizeof(FlipChangerIndexEntry) * MAX_SLOTS);
+    memset(index, 0, sizeof(FlipChangerIndexEntry) * MAX_SLOTS);
+    json_reader_init(reader, stream);
+    
+    bool result = flipchanger_parse_collection(app, reader, scratch, tracks, index);
+    if(!result) {
+        FURI_LOG_W(TAG, "Data file parse stopped at byte %lu", (unsigned long)reader->token_offset);
+    }
+    
+    track_list_free(tracks);
+    free(scratch);
+    free(reader);
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    
+    flipchanger_index_write(app, index);
+    free(index);
+    
+    // Record which JSON the database was built from (summaries first, so a
+    // stamped database always has them). A partial import stays unstamped - the
+    // next start rebuilds it instead of trusting it
+    flipchanger_db_flush(app->db);
+    FlipChangerDbStamp stamp;
+    flipchanger_db_set_total_slots(app->db, app->total_slots);
+    if(result && flipchanger_db_stat_source(app->storage, FLIPCHANGER_DATA_PATH, &stamp)) {
+        flipchanger_db_set_source(app->db, &stamp);
+    }
+    app->import_partial = !result;
+    
+    return result;
+}
+
+// Load one slot straight from the JSON - seek to its object and parse only that
+// (track titles are skipped unless tracks is given)
+static bool flipchanger_load_slot_from_json(
+    FlipChangerApp* app,
+    int32_t slot_index,
+    Slot* slot,
+    TrackList* tracks) {
+    memset(slot, 0, sizeof(Slot));
+    slot->slot_number = slot_index + 1;
+    if(tracks) {
+        track_list_reset(tracks);
+    }
+    
+    FlipChangerIndexEntry entry;
+    if(!flipchanger_index_lookup(app, slot_index, &entry)) {
+        return false;
+    }
+    if(entry.length == 0) {
+        return true;  // Slot not present in the file - empty
+    }
+    
+    Stream* stream = buffered_file_stream_alloc(app->storage);
+    bool result = false;
+    if(buffered_file_stream_open(stream, FLIPCHANGER_DATA_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       stream_seek(stream, entry.offset, StreamOffsetFromStart)) {
+        JsonReader* reader = malloc(sizeof(JsonReader));
+        json_reader_init(reader, stream);
+        result = json_reader_next(reader) == JsonTokenObjectStart &&
+                 flipchanger_parse_slot(reader, slot, tracks);
+        free(reader);
+        buffered_file_stream_close(stream);
+    }
+    stream_free(stream);
+    
+    slot->slot_number = slot_index + 1;
+    return result;
+}
+
+// Load data - opens the slot database, rebuilding it from JSON if missing or stale
+bool flipchanger_load_data(FlipChangerApp* app) {
+    if(!app || !app->storage) {
+        return false;
+    }
+    
+    // Start from defaults, dropping cached slots but keeping the UI position
+    app->total_slots = DEFAULT_SLOTS;
+    flipchanger_reset_cache(app);
+    
+    if(!app->db) {
+        app->db = flipchanger_db_alloc(app->storage);
+    }
+    
+    flipchanger_recover_json(app);
+    
+    FlipChangerDbStamp stamp;
+    bool has_json = flipchanger_db_stat_source(app->storage, FLIPCHANGER_DATA_PATH, &stamp);
+    if(!flipchanger_db_open(app->db, has_json ? &stamp : NULL)) {
+        // Rebuilding anyway - fall back to the backup if the data file will not parse
+        if(!flipchanger_verify_json(app, FLIPCHANGER_DATA_PATH)) {
+            flipchanger_restore_backup(app);
+        }
+        return flipchanger_import_json(app);
+    }
+    
+    // Database is current - slots are read as they are needed
+    app->total_slots = flipchanger_db_get_total_slots(app->db);
+    return true;
+}
+
+// Helper: Write one slot object
+static void flipchanger_write_slot_json(
+    JsonWriter* writer,
+    const Slot* slot,
+    const TrackList* tracks) {
+    // Slot number and occupied (comma before artist so empty slots end without a trailing one)
+    json_writer_text(writer, "{\"slot\":");
+    json_writer_int(writer, slot->slot_number);
+    json_writer_text(writer, slot->occupied ? ",\"occupied\":true" : ",\"occupied\":false");
+    
+    if(slot->occupied) {
+        json_writer_text(writer, ",\"artist\":");
+        json_writer_string(writer, slot->cd.artist);
+        json_writer_text(writer, ",\"album\":");
+        json_writer_string(writer, slot->cd.album);
+        json_writer_text(writer, ",\"year\":");
+        json_writer_int(writer, slot->cd.year);
+        json_writer_text(writer, ",\"genre\":");
+        json_writer_string(writer, slot->cd.genre);
+        
+        // Tracks array
+        json_writer_text(writer, ",\"tracks\":[");
+        for(int32_t t = 0; t < slot->cd.track_count && t < tracks->count; t++) {
+            json_writer_text(writer, t > 0 ? ",{\"num\":" : "{\"num\":");
+            json_writer_int(writer, tracks->tracks[t].number);
+            json_writer_text(writer, ",\"title\":");
+            json_writer_string(writer, track_list_title(tracks, t));
+            char duration[MAX_TRACK_DURATION_LENGTH];
+            track_duration_format(tracks->tracks[t].duration, duration, sizeof(duration));
+            json_writer_text(writer, ",\"duration\":");
+            json_writer_string(writer, duration);
+            json_writer_text(writer, "}");
+        }
+        
+        // Notes
+        json_writer_text(writer, "],\"notes\":");
+        json_writer_string(writer, slot->cd.notes);
+    }
+    
+    json_writer_text(writer, "}");
+}
+
+// Save data - exports every slot from the database to JSON (storage worker - saves queued
+// before this are journaled already). Temp file + rename, so an interrupted save never
+// leaves a truncated data file
+bool flipchanger_save_data(FlipChangerApp* app) {
+    if(!app || !app->storage) {
+        return false;
+    }
+    
+    // Note: Allow saving even if !running (needed for shutdown save)
+    
+    // Database first - it is the source for the export below
+    // (without it the JSON is the only copy and must not be truncated)
+    if(!flipchanger_db_is_open(app->db)) {
+        return false;
+    }
+    
+    // Built from a JSON that did not parse in full - exporting it would replace the
+    // data file (and later the backup) with the part that did
+    if(app->import_partial) {
+        FURI_LOG_W(TAG, "Partial import - data file left unchanged");
+        return false;
+    }
+    
+    // Open file for writing
+    File* file = storage_file_alloc(app->storage);
+    if(!file) {
+        return false;
+    }
+    
+    // Create directory if needed
+    storage_common_mkdir(app->storage, "/ext/apps/Tools");
+    
+    // Export goes to a temp file - the live file is only replaced once this one is complete
+    if(!storage_file_open(file, FLIPCHANGER_DATA_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_free(file);
+        return false;
+    }
+    
+    // All output goes through one sector-sized buffer
+    JsonWriter* writer = malloc(sizeof(JsonWriter));
+    json_writer_init(writer, file);
+    
+    // Write JSON header
+    json_writer_text(writer, "{\"version\":1,\"total_slots\":");
+    json_writer_int(writer, app->total_slots);
+    json_writer_text(writer, ",\"slots\":[");
+    
+    // Write all slots, one record at a time from the database (the cache belongs to the app thread)
+    // Offsets are recorded as we go so the JSON index comes for free
+    Slot* scratch = malloc(sizeof(Slot));
+    TrackList* tracks = track_list_alloc();
+    FlipChangerIndexEntry* index = malloc(sizeof(FlipChangerIndexEntry) * MAX_SLOTS);
+    memset(index, 0, sizeof(FlipChangerIndexEntry) * MAX_SLOTS);
+    bool read_ok = true;
+    for(int32_t i = 0; i < app->total_slots; i++) {
+        // A record that did not read back would go out as an empty slot (or a slot with no
+        // tracks) and replace the real one in the data file - stop the export instead
+        if(!flipchanger_db_read_slot(app->db, i, scratch) ||
+           (scratch->occupied && scratch->cd.track_count > 0 &&
+            !flipchanger_db_read_tracks(app->db, i, tracks))) {
+            FURI_LOG_E(TAG, "Export: slot %ld did not read back", (long)(i + 1));
+            read_ok = false;
+            break;
+        }
+        
+        if(i > 0) {
+            json_writer_raw(writer, ",", 1);
+        }
+        index[i].offset = (uint32_t)writer->offset;
+        flipchanger_write_slot_json(writer, scratch, tracks);
+        index[i].length = (uint32_t)writer->offset - index[i].offset;
+    }
+    track_list_free(tracks);
+    free(scratch);
+    
+    // Write JSON footer
+    json_writer_raw(writer, "]}", 2);
+    bool result = read_ok && json_writer_flush(writer);
+    FURI_LOG_I(
+        TAG,
+        "Export: %lu bytes in %lu writes",
+        (unsigned long)writer->bytes,
+        (unsigned long)writer->write_calls);
+    free(writer);
+    
+    // Close file (this should flush automatically)
+    result = storage_file_close(file) && result;
+    storage_file_free(file);
+    
+    // Nothing is replaced by an export that did not complete
+    if(!read_ok) {
+        storage_common_remove(app->storage, FLIPCHANGER_DATA_TMP_PATH);
+    }
+    
+    // Read it back before it replaces anything
+    if(result && !flipchanger_verify_json(app, FLIPCHANGER_DATA_TMP_PATH)) {
+        FURI_LOG_E(TAG, "Export did not verify - data file left unchanged");
+        storage_common_remove(app->storage, FLIPCHANGER_DATA_TMP_PATH);
+        result = false;
+    }
+    result = result && flipchanger_commit_json(app);
+    
+    if(result) {
+        app->export_pending = false;
+        
+        // Our own export must not trigger a rebuild on next start
+        FlipChangerDbStamp stamp;
+        if(flipchanger_db_stat_source(app->storage, FLIPCHANGER_DATA_PATH, &stamp)) {
+            flipchanger_db_set_source(app->db, &stamp);
+        }
+        flipchanger_index_write(app, index);
+    }
+    free(index);
+    
+    return result;
+}
+
+// Forward declarations
+void flipchanger_draw_track_management(Canvas* canvas, FlipChangerApp* app);
+void flipchanger_draw_settings(Canvas* canvas, FlipChangerApp* app);
+void flipchanger_draw_statistics(Canvas* canvas, FlipChangerApp* app);
+void flipchanger_draw_search(Canvas* canvas, FlipChangerApp* app);
+void flipchanger_draw_filter(Canvas* canvas, FlipChangerApp* app);
+
+// Search view layout
+#define SEARCH_VISIBLE_RESULTS 3
+#define SEARCH_VISIBLE_QUERY 12  // Characters of the query shown
+
+// Statistics view layout
+#define STATS_VISIBLE_LINES 4
+#define STATS_LINE_LENGTH 40
+
+// Filter view layout
+#define FILTER_VISIBLE_ROWS 4
+#define FILTER_ROW_LENGTH 40
+
+// Filter view rows: "Show all", "Occupied only", then every genre and decade that has discs
+// (or is picked, so it can be unpicked after its last disc went)
+typedef enum {
+    FilterRowAll,
+    FilterRowOccupied,
+    FilterRowGenre,   // value = genre id
+    FilterRowDecade,  // value = facet decade
+} FilterRowType;
+
+// Helper: What one row of the filter view is - false past the last row
+static bool flipchanger_filter_row(FlipChangerApp* app, int32_t row, FilterRowType* type, int32_t* value) {
+    *value = 0;
+    if(row < 0) {
+        return false;
+    }
+    if(row <= FilterRowOccupied) {
+        *type = (FilterRowType)row;
+        return true;
+    }
+    row -= 2;
+    
+    const CollectionStats* stats = flipchanger_get_stats(app);
+    for(int32_t id = 1; id <= STRING_TABLE_MAX_ENTRIES; id++) {
+        bool picked = (app->filter_genres[(id - 1) / 32] >> ((id - 1) % 32)) & 1u;
+        if((picked || stats->genre[id - 1] > 0) && row-- == 0) {
+            *type = FilterRowGenre;
+            *value = id;
+            return true;
+        }
+    }
+    
+    const FacetIndex* facets = flipchanger_db_get_facets(app->db);
+    for(int32_t decade = 0; decade < FACET_DECADES; decade++) {
+        uint32_t bits[SLOT_BITMAP_WORDS] = {0};
+        facet_index_or_decade(facets, decade, bits);
+        bool used = (app->filter_decades >> decade) & 1u;
+        for(int32_t w = 0; w < SLOT_BITMAP_WORDS && !used; w++) {
+            used = bits[w] != 0;
+        }
+        if(used && row-- == 0) {
+            *type = FilterRowDecade;
+            *value = decade;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Helper: Number of rows in the filter view
+static int32_t flipchanger_filter_row_count(FlipChangerApp* app) {
+    FilterRowType type;
+    int32_t value;
+    int32_t count = 0;
+    while(flipchanger_filter_row(app, count, &type, &value)) {
+        count++;
+    }
+    return count;
+}
+
+// Helper: Pick/unpick a filter row ("Show all" drops every pick)
+static void flipchanger_filter_toggle(FlipChangerApp* app, FilterRowType type, int32_t value) {
+    switch(type) {
+        case FilterRowAll:
+            app->filter_occupied = false;
+            app->filter_decades = 0;
+            memset(app->filter_genres, 0, sizeof(app->filter_genres));
+            break;
+        case FilterRowOccupied:
+            app->filter_occupied = !app->filter_occupied;
+            break;
+        case FilterRowGenre:
+            app->filter_genres[(value - 1) / 32] ^= 1u << ((value - 1) % 32);
+            break;
+        case FilterRowDecade:
+            app->filter_decades ^= 1u << value;
+            break;
+    }
+}
+
+// Helper: Format one row of the filter view - check box, value, discs
+static void flipchanger_filter_row_text(
+    FlipChangerApp* app,
+    FilterRowType type,
+    int32_t value,
+    char* text,
+    size_t size) {
+    switch(type) {
+        case FilterRowAll:
+            snprintf(text, size, "[%c] Show all", flipchanger_filter_active(app) ? ' ' : 'x');
+            break;
+        case FilterRowOccupied:
+            snprintf(
+                text,
+                size,
+                "[%c] Occupied (%ld)",
+                app->filter_occupied ? 'x' : ' ',
+                (long)flipchanger_count_occupied_slots(app));
+            break;
+        case FilterRowGenre:
+            snprintf(
+                text,
+                size,
+                "[%c] %.24s (%u)",
+                ((app->filter_genres[(value - 1) / 32] >> ((value - 1) % 32)) & 1u) ? 'x' : ' ',
+                flipchanger_get_string(app, (uint16_t)value),
+                (unsigned)flipchanger_get_stats(app)->genre[value - 1]);
+            break;
+        case FilterRowDecade: {
+            uint32_t bits[SLOT_BITMAP_WORDS] = {0};
+            facet_index_or_decade(flipchanger_db_get_facets(app->db), value, bits);
+            int32_t discs = 0;
+            for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+                discs += __builtin_popcount(bits[w]);
+            }
+            char check = ((app->filter_decades >> value) & 1u) ? 'x' : ' ';
+            if(value == FACET_NO_YEAR) {
+                snprintf(text, size, "[%c] No year (%ld)", check, (long)discs);
+            } else {
+                snprintf(
+                    text, size, "[%c] %ds (%ld)", check, (int)(STATS_FIRST_YEAR + value * 10), (long)discs);
+            }
+            break;
+        }
+    }
+}
+
+// Helper: Format one line of the statistics view - false past the last line
+// (top lists are picked from the totals each time - a few passes over small arrays)
+static bool flipchanger_stats_line(FlipChangerApp* app, int32_t line, char* text, size_t size) {
+    const CollectionStats* stats = flipchanger_get_stats(app);
+    if(line < 0) {
+        return false;
+    }
+
+    // Totals
+    if(line == 0) {
+        snprintf(text, size, "Discs: %u of %ld", (unsigned)stats->discs, (long)app->total_slots);
+        return true;
+    }
+    if(line == 1) {
+        snprintf(text, size, "Tracks: %u", (unsigned)stats->tracks);
+        return true;
+    }
+    if(line == 2) {
+        char time[MAX_TRACK_DURATION_LENGTH];
+        track_duration_format(stats->seconds, time, sizeof(time));
+        snprintf(text, size, "Playing time: %s", time[0] ? time : "-");
+        return true;
+    }
+    line -= 3;
+
+    // Top genres and artists, each under a heading
+    const uint8_t* counts[] = {stats->genre, stats->artist};
+    const char* headings[] = {"Top genres:", "Top artists:"};
+    for(int32_t list = 0; list < 2; list++) {
+        uint16_t ids[STATS_TOP];
+        int32_t found = collection_stats_top(counts[list], ids, STATS_TOP);
+        if(found == 0) {
+            continue;
         }
-        storage_file_write(file, (const uint8_t*)p, 1);
-        p++;
+        if(line == 0) {
+            snprintf(text, size, "%s", headings[list]);
+            return true;
+        }
+        if(line <= found) {
+            uint16_t id = ids[line - 1];
+            snprintf(
+                text,
+                size,
+                " %.24s (%u)",
+                flipchanger_get_string(app, id),
+                (unsigned)counts[list][id - 1]);
+            return true;
+        }
+        line -= found + 1;
     }
-    
-    storage_file_write(file, (const uint8_t*)"\"", 1);
-}
 
-// Save data to JSON file (saves cached slots)
-bool flipchanger_save_data(FlipChangerApp* app) {
-    if(!app || !app->storage) {
-        return false;
-    }
-    
-    // Note: Allow saving even if !running (needed for shutdown save)
-    
-    // Open file for writing
-    File* file = storage_file_alloc(app->storage);
-    if(!file) {
+    // Discs per decade
+    if(stats->discs == 0) {
         return false;
     }
-    
-    // Create directory if needed
-    storage_common_mkdir(app->storage, "/ext/apps/Tools");
-    
-    if(!storage_file_open(file, FLIPCHANGER_DATA_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-        storage_file_free(file);
-        return false;
+    if(line == 0) {
+        snprintf(text, size, "Decades:");
+        return true;
     }
-    
-    // Write JSON header
-    char header[128];
-    snprintf(header, sizeof(header), "{\"version\":1,\"total_slots\":%ld,\"slots\":[", (long)app->total_slots);
-    storage_file_write(file, (const uint8_t*)header, strlen(header));
-    
-    // Write cached slots
-    bool first = true;
-    for(int32_t i = 0; i < SLOT_CACHE_SIZE && i < app->total_slots; i++) {
-        Slot* slot = &app->slots[i];
-        
-        if(!first) {
-            storage_file_write(file, (const uint8_t*)",", 1);
+    line--;
+    for(int32_t i = 0; i < STATS_DECADES; i++) {
+        if(stats->decade[i] == 0) {
+            continue;
         }
-        first = false;
-        
-        storage_file_write(file, (const uint8_t*)"{", 1);
-        
-        // Slot number
-        char slot_num[32];
-        snprintf(slot_num, sizeof(slot_num), "\"slot\":%ld,", (long)slot->slot_number);
-        storage_file_write(file, (const uint8_t*)slot_num, strlen(slot_num));
-        
-        // Occupied
-        char occ_str[24];
-        snprintf(occ_str, sizeof(occ_str), "\"occupied\":%s,", slot->occupied ? "true" : "false");
-        storage_file_write(file, (const uint8_t*)occ_str, strlen(occ_str));
-        
-        if(slot->occupied) {
-            // Artist
-            storage_file_write(file, (const uint8_t*)"\"artist\":", 9);
-            write_json_string(file, slot->cd.artist);
-            storage_file_write(file, (const uint8_t*)",", 1);
-            
-            // Album
-            storage_file_write(file, (const uint8_t*)"\"album\":", 8);
-            write_json_string(file, slot->cd.album);
-            storage_file_write(file, (const uint8_t*)",", 1);
-            
-            // Year
-            char year_str[32];
-            snprintf(year_str, sizeof(year_str), "\"year\":%ld,", (long)slot->cd.year);
-            storage_file_write(file, (const uint8_t*)year_str, strlen(year_str));
-            
-            // Genre
-            storage_file_write(file, (const uint8_t*)"\"genre\":", 8);
-            write_json_string(file, slot->cd.genre);
-            storage_file_write(file, (const uint8_t*)",", 1);
-            
-            // Tracks array
-            storage_file_write(file, (const uint8_t*)"\"tracks\":[", 10);
-            bool first_track = true;
-            for(int32_t t = 0; t < slot->cd.track_count && t < MAX_TRACKS; t++) {
-                if(!first_track) {
-                    storage_file_write(file, (const uint8_t*)",", 1);
-                }
-                first_track = false;
-                
-                storage_file_write(file, (const uint8_t*)"{", 1);
-                
-                // Track number
-                char track_num[32];
-                snprintf(track_num, sizeof(track_num), "\"num\":%ld,", (long)slot->cd.tracks[t].number);
-                storage_file_write(file, (const uint8_t*)track_num, strlen(track_num));
-                
-                // Track title
-                storage_file_write(file, (const uint8_t*)"\"title\":", 8);
-                write_json_string(file, slot->cd.tracks[t].title);
-                storage_file_write(file, (const uint8_t*)",", 1);
-                
-                // Track duration
-                storage_file_write(file, (const uint8_t*)"\"duration\":", 11);
-                write_json_string(file, slot->cd.tracks[t].duration);
-                
-                storage_file_write(file, (const uint8_t*)"}", 1);
-            }
-            storage_file_write(file, (const uint8_t*)"],", 2);
-            
-            // Notes
-            storage_file_write(file, (const uint8_t*)"\"notes\":", 8);
-            write_json_string(file, slot->cd.notes);
+        if(line == 0) {
+            snprintf(
+                text,
+                size,
+                " %ds: %u",
+                (int)(STATS_FIRST_YEAR + i * 10),
+                (unsigned)stats->decade[i]);
+            return true;
         }
-        
-        storage_file_write(file, (const uint8_t*)"}", 1);
+        line--;
     }
-    
-    // Write JSON footer
-    storage_file_write(file, (const uint8_t*)"]}", 2);
-    
-    // Close file (this should flush automatically)
-    bool result = storage_file_close(file);
-    storage_file_free(file);
-    
-    if(result) {
-        app->dirty = false;
+    uint16_t unknown = collection_stats_unknown_year(stats);
+    if(unknown > 0 && line == 0) {
+        snprintf(text, size, " Unknown: %u", (unsigned)unknown);
+        return true;
     }
-    
-    return result;
+    return false;
 }
 
-// Forward declarations
-void flipchanger_draw_track_management(Canvas* canvas, FlipChangerApp* app);
-void flipchanger_draw_settings(Canvas* canvas, FlipChangerApp* app);
-void flipchanger_draw_statistics(Canvas* canvas, FlipChangerApp* app);
+// Helper: Number of lines in the statistics view
+static int32_t flipchanger_stats_line_count(FlipChangerApp* app) {
+    char line[STATS_LINE_LENGTH];
+    int32_t count = 0;
+    while(flipchanger_stats_line(app, count, line, sizeof(line))) {
+        count++;
+    }
+    return count;
+}
+
+// Main menu layout
+#define MAIN_MENU_ITEMS 6
+#define MAIN_MENU_VISIBLE 4  // Rows above the footer
 
 // Draw main menu
 void flipchanger_draw_main_menu(Canvas* canvas, FlipChangerApp* app) {
@@ -545,16 +1979,24 @@ void flipchanger_draw_main_menu(Canvas* canvas, FlipChangerApp* app) {
     canvas_set_font(canvas, FontSecondary);
     
     int32_t y = 22;  // Adjusted starting position
-    const char* menu_items[] = {
+    const char* menu_items[MAIN_MENU_ITEMS] = {
         "View Slots",
+        "Search",
+        "Filter",
         "Add CD",
         "Statistics",
         "Settings"
     };
     
-    int32_t selected = app->selected_index % 4;
+    int32_t selected = app->selected_index % MAIN_MENU_ITEMS;
+    
+    // Scroll so the selection stays in the visible rows
+    int32_t first = selected - (MAIN_MENU_VISIBLE - 1);
+    if(first < 0) {
+        first = 0;
+    }
     
-    for(int32_t i = 0; i < 4; i++) {
+    for(int32_t i = first; i < first + MAIN_MENU_VISIBLE; i++) {
         if(i == selected) {
             canvas_draw_box(canvas, 5, y - 8, 118, 10);
             canvas_invert_color(canvas);
@@ -579,22 +2021,40 @@ void flipchanger_draw_slot_list(Canvas* canvas, FlipChangerApp* app) {
     
     // Header
     char header[32];
-    snprintf(header, sizeof(header), "Slots (%ld total)", app->total_slots);
+    int32_t row_count = flipchanger_list_count(app);
+    if(app->sort_order == SortBySlot && flipchanger_filter_active(app)) {
+        snprintf(header, sizeof(header), "Slots (%ld of %ld)", (long)row_count, (long)app->total_slots);
+    } else if(app->sort_order == SortBySlot) {
+        snprintf(header, sizeof(header), "Slots (%ld total)", app->total_slots);
+    } else if(app->sort_order == SortByArtist && row_count > 0) {
+        // Letter under the cursor - held Left/Right jump between them
+        snprintf(
+            header,
+            sizeof(header),
+            "By %s (%ld) %c",
+            sort_order_name(app->sort_order),
+            (long)row_count,
+            flipchanger_artist_initial(app, flipchanger_list_slot(app, app->selected_index)));
+    } else {
+        snprintf(header, sizeof(header), "By %s (%ld)", sort_order_name(app->sort_order), (long)row_count);
+    }
     canvas_draw_str(canvas, 5, 10, header);
     
-    // Calculate visible slots (4 per screen to leave room for footer)
+    // Calculate visible rows (4 per screen to leave room for footer)
     int32_t visible_count = 4;
     int32_t start_index = app->scroll_offset;
     int32_t end_index = start_index + visible_count;
-    if(end_index > app->total_slots) {
-        end_index = app->total_slots;
+    if(end_index > row_count) {
+        end_index = row_count;
     }
     
     canvas_set_font(canvas, FontSecondary);
     int32_t y = 18;  // Start slightly higher
     
-    // Don't update cache during draw - only read from cache
-    // Cache should be updated before entering this view
+    // Rows come from the resident summaries - no cache or SD access during draw
+    if(row_count == 0) {
+        canvas_draw_str(canvas, 5, 30, "No slots match the filter");
+    }
     
     // Ensure we only show exactly 4 items (or fewer if total_slots < 4)
     int32_t items_to_show = (end_index - start_index);
@@ -605,15 +2065,44 @@ void flipchanger_draw_slot_list(Canvas* canvas, FlipChangerApp* app) {
     
     for(int32_t i = start_index; i < end_index && (i - start_index) < 4; i++) {
         char line[80];  // Increased buffer size
-        Slot* slot = flipchanger_get_slot(app, i);
+        int32_t slot_index = flipchanger_list_slot(app, i);
+        const SlotSummary* summary = flipchanger_get_summary(app, slot_index);
         
-        if(slot && slot->occupied) {
-            // Truncate artist name if too long to fit
-            char artist_short[40];
-            snprintf(artist_short, sizeof(artist_short), "%.39s", slot->cd.artist);
-            snprintf(line, sizeof(line), "%ld: %s", (long)(i + 1), artist_short);
+        if(summary && flipchanger_is_occupied(app, slot_index)) {
+            // Sort key first, cut to what fits on a row (artist in slot and artist order)
+            const char* artist = flipchanger_get_string(app, summary->artist);
+            if(app->sort_order == SortByAlbum) {
+                snprintf(line, sizeof(line), "%ld: %s", (long)(slot_index + 1), summary->album);
+            } else if(app->sort_order == SortByYear && summary->year > 0) {
+                snprintf(
+                    line,
+                    sizeof(line),
+                    "%ld: %u %.*s",
+                    (long)(slot_index + 1),
+                    (unsigned)summary->year,
+                    SUMMARY_TEXT_LENGTH - 6,
+                    artist);
+            } else if(app->sort_order == SortByGenre) {
+                snprintf(
+                    line,
+                    sizeof(line),
+                    "%ld: %.*s/%.*s",
+                    (long)(slot_index + 1),
+                    SUMMARY_TEXT_LENGTH / 2,
+                    flipchanger_get_string(app, summary->genre),
+                    SUMMARY_TEXT_LENGTH / 2,
+                    artist);
+            } else {
+                snprintf(
+                    line,
+                    sizeof(line),
+                    "%ld: %.*s",
+                    (long)(slot_index + 1),
+                    SUMMARY_TEXT_LENGTH - 1,
+                    artist);
+            }
         } else {
-            snprintf(line, sizeof(line), "%ld: [Empty]", (long)(i + 1));
+            snprintf(line, sizeof(line), "%ld: [Empty]", (long)(slot_index + 1));
         }
         
         if(i == app->selected_index) {
@@ -632,8 +2121,8 @@ void flipchanger_draw_slot_list(Canvas* canvas, FlipChangerApp* app) {
     
     // Footer - two lines with abbreviations
     canvas_set_font(canvas, FontKeyboard);
-    canvas_draw_str(canvas, 5, 57, "U/D:Nav K:View B:Return");
-    canvas_draw_str(canvas, 5, 63, "LB:Exit");
+    canvas_draw_str(canvas, 5, 57, "U/D:Nav K:View L/R:Sort");
+    canvas_draw_str(canvas, 5, 63, "HL/R:Jump B:Ret LB:Exit");
 }
 
 // Draw slot details
@@ -651,7 +2140,11 @@ void flipchanger_draw_slot_details(Canvas* canvas, FlipChangerApp* app) {
     
     if(!slot) {
         canvas_set_font(canvas, FontPrimary);
-        canvas_draw_str(canvas, 5, 30, "Slot not loaded");
+        canvas_draw_str(canvas, 5, 30, flipchanger_slot_placeholder(app, app->current_slot_index));
+        if(app->slot_read_failed == app->current_slot_index) {
+            canvas_set_font(canvas, FontKeyboard);
+            canvas_draw_str(canvas, 5, 63, "K:Retry B:Return");
+        }
         return;
     }
     
@@ -747,7 +2240,8 @@ void flipchanger_draw_slot_details(Canvas* canvas, FlipChangerApp* app) {
     canvas_draw_str(canvas, 5, 63, "LB:Exit");
 }
 
-// Draw callback
+// Draw callback (GUI thread) - renders under app->mutex, so it never sees a half-applied
+// input or a cache entry mid-fill. Nothing holds the mutex across SD access
 void flipchanger_draw_callback(Canvas* canvas, void* ctx) {
     FlipChangerApp* app = (FlipChangerApp*)ctx;
     
@@ -757,6 +2251,7 @@ void flipchanger_draw_callback(Canvas* canvas, void* ctx) {
         return;
     }
     
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
     switch(app->current_view) {
         case VIEW_MAIN_MENU:
             flipchanger_draw_main_menu(canvas, app);
@@ -779,12 +2274,19 @@ void flipchanger_draw_callback(Canvas* canvas, void* ctx) {
         case VIEW_STATISTICS:
             flipchanger_draw_statistics(canvas, app);
             break;
+        case VIEW_SEARCH:
+            flipchanger_draw_search(canvas, app);
+            break;
+        case VIEW_FILTER:
+            flipchanger_draw_filter(canvas, app);
+            break;
         default:
             canvas_clear(canvas);
             canvas_set_font(canvas, FontPrimary);
             canvas_draw_str(canvas, 5, 30, "Unknown view");
             break;
     }
+    furi_mutex_release(app->mutex);
 }
 
 // Navigation functions
@@ -810,6 +2312,20 @@ void flipchanger_show_slot_details(FlipChangerApp* app, int32_t slot_index) {
 static const char* CHAR_SET = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 .-,";
 #define CHAR_DEL_INDEX ((int32_t)strlen(CHAR_SET))  // DEL is one past the end of the set
 
+void flipchanger_show_search(FlipChangerApp* app) {
+    app->current_view = VIEW_SEARCH;
+    app->search_query[0] = '\0';
+    app->search_focus_results = false;
+    app->edit_char_selection = 0;
+    flipchanger_search_changed(app, false);
+}
+
+void flipchanger_show_filter(FlipChangerApp* app) {
+    app->current_view = VIEW_FILTER;
+    app->selected_index = 0;
+    app->scroll_offset = 0;
+}
+
 void flipchanger_show_add_edit(FlipChangerApp* app, int32_t slot_index, bool is_new) {
     app->current_view = VIEW_ADD_EDIT_CD;
     app->current_slot_index = slot_index;
@@ -859,7 +2375,7 @@ void flipchanger_draw_add_edit(Canvas* canvas, FlipChangerApp* app) {
     Slot* slot = flipchanger_get_slot(app, app->current_slot_index);
     if(!slot) {
         canvas_set_font(canvas, FontPrimary);
-        canvas_draw_str(canvas, 5, 30, "Slot not loaded");
+        canvas_draw_str(canvas, 5, 30, flipchanger_slot_placeholder(app, app->current_slot_index));
         return;
     }
     
@@ -1123,39 +2639,48 @@ void flipchanger_draw_track_management(Canvas* canvas, FlipChangerApp* app) {
     }
     
     Slot* slot = flipchanger_get_slot(app, app->current_slot_index);
-    if(!slot) {
+    TrackList* tracks = flipchanger_get_tracks(app);
+    if(!slot || !tracks) {
         canvas_set_font(canvas, FontPrimary);
-        canvas_draw_str(canvas, 5, 30, "Slot not loaded");
+        canvas_draw_str(
+            canvas,
+            5,
+            30,
+            !slot              ? flipchanger_slot_placeholder(app, app->current_slot_index) :
+            app->tracks_failed ? "Read error" :
+                                 "Loading...");
+        if(slot && app->tracks_failed) {
+            canvas_set_font(canvas, FontKeyboard);
+            canvas_draw_str(canvas, 5, 63, "K:Retry B:Return");
+        }
         return;
     }
     
-    // Ensure track_count is valid
-    if(slot->cd.track_count < 0) slot->cd.track_count = 0;
-    if(slot->cd.track_count > MAX_TRACKS) slot->cd.track_count = MAX_TRACKS;
-    
-    // Ensure selected track is valid
-    if(app->edit_selected_track < 0) app->edit_selected_track = 0;
-    if(slot->cd.track_count > 0 && app->edit_selected_track >= slot->cd.track_count) {
-        app->edit_selected_track = slot->cd.track_count - 1;
-    }
+    // Never more than the list holds (input clamps the slot itself - draw changes nothing)
+    int32_t track_count = slot->cd.track_count < tracks->count ? slot->cd.track_count : tracks->count;
     
     canvas_set_font(canvas, FontPrimary);
     
     // Title
     char title[48];
-    snprintf(title, sizeof(title), "Tracks (%ld)", (long)slot->cd.track_count);
+    snprintf(title, sizeof(title), "Tracks (%ld)", (long)track_count);
     canvas_draw_str(canvas, 5, 10, title);
     
     canvas_set_font(canvas, FontSecondary);
     
+    // Album length on right
+    char total[MAX_TRACK_DURATION_LENGTH];
+    track_duration_format(track_list_total_duration(tracks), total, sizeof(total));
+    canvas_draw_str(canvas, 85, 10, total);
+    
     // Show tracks (up to 4 visible)
     int32_t y = 22;
     int32_t start_track = 0;
-    if(slot->cd.track_count > 0 && app->edit_selected_track >= 4) {
+    if(track_count > 0 && app->edit_selected_track >= 4) {
         start_track = app->edit_selected_track - 3;
     }
     
-    for(int32_t i = start_track; i < slot->cd.track_count && i < start_track + 4 && i >= 0 && i < MAX_TRACKS; i++) {
+    for(int32_t i = start_track; i < track_count && i < start_track + 4 && i >= 0 && i < MAX_TRACKS; i++) {
         bool is_selected = (i == app->edit_selected_track);
         
         if(is_selected) {
@@ -1165,14 +2690,21 @@ void flipchanger_draw_track_management(Canvas* canvas, FlipChangerApp* app) {
         
         // Track number and title - ensure track pointer is valid
         char track_line[80];
-        if(i >= 0 && i < MAX_TRACKS) {
-            Track* track = &slot->cd.tracks[i];
-            snprintf(track_line, sizeof(track_line), "%ld. %s", (long)track->number, track->title);
+        if(i >= 0 && i < tracks->count) {
+            Track* track = &tracks->tracks[i];
+            snprintf(
+                track_line,
+                sizeof(track_line),
+                "%ld. %s",
+                (long)track->number,
+                track_list_title(tracks, i));
             canvas_draw_str(canvas, 5, y, track_line);
             
             // Duration on right
-            if(strlen(track->duration) > 0) {
-                canvas_draw_str(canvas, 100, y, track->duration);
+            if(track->duration > 0) {
+                char duration[MAX_TRACK_DURATION_LENGTH];
+                track_duration_format(track->duration, duration, sizeof(duration));
+                canvas_draw_str(canvas, 100, y, duration);
             }
         }
         
@@ -1184,8 +2716,8 @@ void flipchanger_draw_track_management(Canvas* canvas, FlipChangerApp* app) {
     }
     
     // Show editing interface if editing a track
-    if(app->editing_track && app->edit_selected_track >= 0 && app->edit_selected_track < slot->cd.track_count) {
-        Track* track = &slot->cd.tracks[app->edit_selected_track];
+    if(app->editing_track && app->edit_selected_track >= 0 && app->edit_selected_track < track_count) {
+        Track* track = &tracks->tracks[app->edit_selected_track];
         if(track) {
             canvas_set_font(canvas, FontSecondary);
             int32_t edit_y = 50;
@@ -1193,7 +2725,7 @@ void flipchanger_draw_track_management(Canvas* canvas, FlipChangerApp* app) {
             // Show which field is being edited
             if(app->edit_track_field == TRACK_FIELD_TITLE) {
                 canvas_draw_str(canvas, 5, edit_y, "Title:");
-                char* field = track->title;
+                const char* field = track_list_title(tracks, app->edit_selected_track);
                 int32_t field_len = strlen(field);
                 
                 // Display with scrolling
@@ -1240,7 +2772,10 @@ void flipchanger_draw_track_management(Canvas* canvas, FlipChangerApp* app) {
             } else {
                 // Duration field - numeric only (seconds)
                 canvas_draw_str(canvas, 5, edit_y, "Duration (sec):");
-                char* field = track->duration;
+                char field[MAX_TRACK_DURATION_LENGTH] = "";
+                if(track->duration > 0) {
+                    snprintf(field, sizeof(field), "%u", (unsigned)track->duration);
+                }
                 
                 // Display duration value
                 canvas_draw_str(canvas, 70, edit_y, field);
@@ -1273,18 +2808,18 @@ void flipchanger_draw_track_management(Canvas* canvas, FlipChangerApp* app) {
 }
 
 // Input callback
-void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
-    FlipChangerApp* app = (FlipChangerApp*)ctx;
-    
-    // Safety check - don't process input if app is exiting
-    if(!app || !app->running) {
-        return;
-    }
-    
+// Handle one input event (caller holds app->mutex)
+static void flipchanger_handle_input(FlipChangerApp* app, InputEvent* input_event) {
     // Handle both short press and long press
     bool is_long_press = (input_event->type == InputTypeLong || input_event->type == InputTypeRepeat);
     bool is_short_press = (input_event->type == InputTypePress);
     
+    // Left/Right in the slot list jump while held, so changing the order waits for the release
+    if(app->current_view == VIEW_SLOT_LIST &&
+       (input_event->key == InputKeyLeft || input_event->key == InputKeyRight)) {
+        is_short_press = (input_event->type == InputTypeShort);
+    }
+    
     if(!is_short_press && !is_long_press) {
         return;
     }
@@ -1292,21 +2827,32 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
     switch(app->current_view) {
         case VIEW_MAIN_MENU:
             if(input_event->key == InputKeyUp) {
-                app->selected_index = (app->selected_index + 3) % 4;  // Wrap around
+                app->selected_index =
+                    (app->selected_index + MAIN_MENU_ITEMS - 1) % MAIN_MENU_ITEMS;  // Wrap around
             } else if(input_event->key == InputKeyDown) {
-                app->selected_index = (app->selected_index + 1) % 4;
+                app->selected_index = (app->selected_index + 1) % MAIN_MENU_ITEMS;
             } else if(input_event->key == InputKeyOk) {
                 switch(app->selected_index) {
                     case 0:  // View Slots
                         flipchanger_show_slot_list(app);
                         break;
-                    case 1:  // Add CD
+                    case 1:  // Search
+                        flipchanger_show_search(app);
+                        break;
+                    case 2:  // Filter
+                        flipchanger_show_filter(app);
+                        break;
+                    case 3:  // Add CD
+                        // Empty slots are only listed by number, and without a filter
+                        app->sort_order = SortBySlot;
+                        flipchanger_filter_toggle(app, FilterRowAll, 0);
                         flipchanger_show_slot_list(app);  // Show slots first to select
                         break;
-                    case 2:  // Statistics
-                        // TODO: Show statistics
+                    case 4:  // Statistics
+                        app->current_view = VIEW_STATISTICS;
+                        app->details_scroll_offset = 0;
                         break;
-                    case 3:  // Settings
+                    case 5:  // Settings
                         // TODO: Show settings
                         break;
                 }
@@ -1325,19 +2871,42 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                     if(app->selected_index < app->scroll_offset) {
                         app->scroll_offset = app->selected_index;
                     }
+                    flipchanger_request_prefetch(app, -1, is_long_press);
                 }
             } else if(input_event->key == InputKeyDown) {
-                if(app->selected_index < app->total_slots - 1) {
+                if(app->selected_index < flipchanger_list_count(app) - 1) {
                     app->selected_index++;
                     // Auto-scroll
                     if(app->selected_index >= app->scroll_offset + 4) {
                         app->scroll_offset = app->selected_index - 3;
                     }
+                    flipchanger_request_prefetch(app, 1, is_long_press);
+                }
+            } else if(input_event->key == InputKeyLeft || input_event->key == InputKeyRight) {
+                int32_t direction = input_event->key == InputKeyRight ? 1 : -1;
+                if(is_long_press) {
+                    // Held - jump a page (a longer one once it repeats), or a letter in artist order
+                    int32_t page = input_event->type == InputTypeRepeat ? LIST_FAST_PAGE : LIST_PAGE;
+                    flipchanger_list_jump(
+                        app,
+                        app->sort_order == SortByArtist ?
+                            flipchanger_list_initial_row(app, direction) :
+                            app->selected_index + direction * page);
+                } else {
+                    // Next/previous order - straight from the sort indexes, the cursor stays on its disc
+                    int32_t slot_index = flipchanger_list_slot(app, app->selected_index);
+                    int32_t step = direction > 0 ? 1 : SortByCount - 1;
+                    app->sort_order = (SortOrder)((app->sort_order + step) % SortByCount);
+                    int32_t row = flipchanger_list_row(app, slot_index);
+                    flipchanger_list_jump(app, row >= 0 ? row : 0);
                 }
             } else if(input_event->key == InputKeyOk) {
-                // Update cache before viewing
-                flipchanger_update_cache(app, app->selected_index);
-                flipchanger_show_slot_details(app, app->selected_index);
+                // Update cache before viewing (usually already prefetched)
+                int32_t slot_index = flipchanger_list_slot(app, app->selected_index);
+                if(slot_index >= 0) {
+                    flipchanger_update_cache(app, slot_index);
+                    flipchanger_show_slot_details(app, slot_index);
+                }
             } else if(input_event->key == InputKeyBack) {
                 flipchanger_show_main_menu(app);
             }
@@ -1346,14 +2915,20 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
         case VIEW_SLOT_DETAILS: {
             Slot* slot = flipchanger_get_slot(app, app->current_slot_index);
             if(input_event->key == InputKeyOk) {
-                // If empty, go to add. If occupied, go to edit
-                if(!slot || !slot->occupied) {
-                    flipchanger_show_add_edit(app, app->current_slot_index, true);
-                } else {
-                    flipchanger_show_add_edit(app, app->current_slot_index, false);
+                // If empty, go to add. If occupied, go to edit (ignored until it has loaded)
+                if(slot) {
+                    flipchanger_show_add_edit(app, app->current_slot_index, !slot->occupied);
+                } else if(app->slot_read_failed == app->current_slot_index) {
+                    flipchanger_update_cache(app, app->current_slot_index);  // Read again
                 }
             } else if(input_event->key == InputKeyBack) {
-                flipchanger_show_slot_list(app);
+                if(app->details_from_search) {
+                    // Back to the results it was opened from
+                    app->current_view = VIEW_SEARCH;
+                    app->details_from_search = false;
+                } else {
+                    flipchanger_show_slot_list(app);
+                }
             }
             break;
         }
@@ -1397,7 +2972,7 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                 if(input_event->key == InputKeyOk) {
                     // Save the slot
                     slot->occupied = true;
-                    app->dirty = true;
+                    flipchanger_mark_dirty(app, app->current_slot_index);
                     flipchanger_save_slot_to_sd(app, app->current_slot_index);
                     notification_message(app->notifications, &sequence_blink_green_100);
                     flipchanger_show_slot_details(app, app->current_slot_index);
@@ -1467,9 +3042,9 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                     if(app->edit_char_selection >= 26 && app->edit_char_selection < 36) {
                         // Number selected (0-9)
                         int32_t digit = app->edit_char_selection - 26;
-                        slot->cd.year = slot->cd.year * 10 + digit;
-                        if(slot->cd.year > 9999) slot->cd.year = 9999;
-                        app->dirty = true;
+                        int32_t year = slot->cd.year * 10 + digit;
+                        slot->cd.year = year > 9999 ? 9999 : (uint16_t)year;
+                        flipchanger_mark_dirty(app, app->current_slot_index);
                     }
                 } else if(input_event->key == InputKeyBack) {
                     if(is_long_press) {
@@ -1478,7 +3053,7 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                     } else {
                         // Short press - delete last digit
                         slot->cd.year = slot->cd.year / 10;
-                        app->dirty = true;
+                        flipchanger_mark_dirty(app, app->current_slot_index);
                     }
                 }
             } else {
@@ -1583,8 +3158,8 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                         if(app->edit_char_selection >= 26 && app->edit_char_selection < 36) {
                             // Number selected (0-9)
                             int32_t digit = app->edit_char_selection - 26;
-                            slot->cd.year = slot->cd.year * 10 + digit;
-                            if(slot->cd.year > 9999) slot->cd.year = 9999;
+                            int32_t year = slot->cd.year * 10 + digit;
+                            slot->cd.year = year > 9999 ? 9999 : (uint16_t)year;
                         }
                     } else {
                         // Text field
@@ -1622,12 +3197,14 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                                     for(int32_t i = app->edit_char_pos; i < len; i++) {
                                         field[i] = field[i + 1];
                                     }
+                                    flipchanger_mark_dirty(app, app->current_slot_index);
                                 } else if(app->edit_char_pos > 0 && len > 0) {
                                     // Delete character before cursor
                                     app->edit_char_pos--;
                                     for(int32_t i = app->edit_char_pos; i < len; i++) {
                                         field[i] = field[i + 1];
                                     }
+                                    flipchanger_mark_dirty(app, app->current_slot_index);
                                 }
                             } else if(app->edit_char_pos >= 0 && app->edit_char_pos < max_len - 1) {
                                 // Insert character
@@ -1653,6 +3230,7 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                                         }
                                     field[app->edit_char_pos] = ch;
                                     field[len + 1] = '\0';
+                                    flipchanger_mark_dirty(app, app->current_slot_index);
                                     if(app->edit_char_pos < max_len - 2) {
                                         app->edit_char_pos++;
                                     }
@@ -1665,16 +3243,12 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                 }
                 } else if(input_event->key == InputKeyBack) {
                     // BACK exits field editing - returns to slot details view
-                    // Changes are preserved and will be saved when navigating away or on app exit
+                    // Changes are marked dirty as they are made - written back when the slot is
+                    // evicted from the cache or on app exit, even without Save
                     // To delete characters, use DEL option in character selector, then OK
                     flipchanger_show_slot_details(app, app->current_slot_index);
                 }
             }
-            
-            // Only update if app is still running
-            if(app->running && app->view_port) {
-                view_port_update(app->view_port);
-            }
             break;
         }
             
@@ -1691,9 +3265,15 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                 break;
             }
             
+            // Only BACK (and OK to retry a failed read) works until the slot and its track list
+            // have loaded
             Slot* slot = flipchanger_get_slot(app, app->current_slot_index);
-            if(!slot) {
-                if(input_event->key == InputKeyBack) {
+            TrackList* tracks = flipchanger_get_tracks(app);
+            if(!slot || !tracks) {
+                if(input_event->key == InputKeyOk && slot && app->tracks_failed) {
+                    app->tracks_failed = false;
+                    app->tracks_requested = false;  // Queued again by flipchanger_sync_tracks
+                } else if(input_event->key == InputKeyBack) {
                     if(is_long_press) {
                         app->current_view = VIEW_SLOT_LIST;
                     } else {
@@ -1703,9 +3283,9 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                 break;
             }
             
-            // Ensure track_count is valid
-            if(slot->cd.track_count < 0) slot->cd.track_count = 0;
-            if(slot->cd.track_count > MAX_TRACKS) slot->cd.track_count = MAX_TRACKS;
+            // Ensure track_count is valid (never more than the list holds - only reached once the
+            // list has loaded, a failed read never gets here)
+            if(slot->cd.track_count > tracks->count) slot->cd.track_count = tracks->count;
             
             // Ensure selected track is valid
             if(app->edit_selected_track < 0) app->edit_selected_track = 0;
@@ -1715,11 +3295,16 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
             
             if(app->editing_track) {
                 // Editing track title or duration
-                Track* track = &slot->cd.tracks[app->edit_selected_track];
-                if(!track) {
+                if(app->edit_selected_track >= tracks->count) {
                     app->editing_track = false;
                     break;
                 }
+                Track* track = &tracks->tracks[app->edit_selected_track];
+                
+                // Title is edited in a copy - pooled titles cannot grow in place
+                char title[MAX_TRACK_TITLE_LENGTH];
+                strncpy(title, track_list_title(tracks, app->edit_selected_track), sizeof(title) - 1);
+                title[sizeof(title) - 1] = '\0';
                 
                 // Ensure edit_track_field is valid
                 int32_t track_field_int = (int32_t)app->edit_track_field;
@@ -1738,15 +3323,21 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                     app->edit_char_selection = 0;
                 }
                 
+                // Duration is stored as seconds - its digits are only needed for the cursor
+                char duration[MAX_TRACK_DURATION_LENGTH] = "";
+                if(track->duration > 0) {
+                    snprintf(duration, sizeof(duration), "%u", (unsigned)track->duration);
+                }
+                
                 char* field = NULL;
                 int32_t max_len = 0;
                 
                 if(app->edit_track_field == TRACK_FIELD_TITLE) {
-                    field = track->title;
+                    field = title;
                     max_len = MAX_TRACK_TITLE_LENGTH;
                 } else if(app->edit_track_field == TRACK_FIELD_DURATION) {
-                    field = track->duration;
-                    max_len = 16; // Max length for duration string
+                    field = duration;
+                    max_len = MAX_TRACK_DURATION_LENGTH;
                 }
                 
                 if(!field) {
@@ -1805,16 +3396,11 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                         if(app->edit_char_selection >= 26 && app->edit_char_selection < 36) {
                             // Number selected (0-9)
                             int32_t digit = app->edit_char_selection - 26;
-                            // Convert duration string to number, add digit, convert back
-                            int32_t current_seconds = 0;
-                            if(strlen(track->duration) > 0) {
-                                current_seconds = atoi(track->duration);
-                            }
-                            current_seconds = current_seconds * 10 + digit;
-                            // Limit to reasonable max (99999 seconds = ~27 hours)
-                            if(current_seconds > 99999) current_seconds = 99999;
-                            snprintf(track->duration, sizeof(track->duration), "%ld", (long)current_seconds);
-                            app->dirty = true;
+                            int32_t current_seconds = track->duration * 10 + digit;
+                            // Limit to what a track stores (65535 seconds = ~18 hours)
+                            if(current_seconds > UINT16_MAX) current_seconds = UINT16_MAX;
+                            track->duration = (uint16_t)current_seconds;
+                            flipchanger_mark_tracks_dirty(app);
                         }
                     } else if(app->edit_char_selection >= CHAR_DEL_INDEX) {
                         // DELETE character at cursor
@@ -1829,7 +3415,7 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                                 field[i] = field[i + 1];
                             }
                         }
-                        app->dirty = true;
+                        flipchanger_mark_tracks_dirty(app);
                     } else if(app->edit_track_field == TRACK_FIELD_TITLE && 
                               app->edit_char_pos >= 0 && app->edit_char_pos < max_len - 1) {
                         // Insert character (for title field only - duration is numeric)
@@ -1852,7 +3438,7 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                                 }
                             }
                         }
-                        app->dirty = true;
+                        flipchanger_mark_tracks_dirty(app);
                     }
                 } else if(input_event->key == InputKeyBack) {
                     if(is_long_press) {
@@ -1878,17 +3464,8 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                             // Not at start - delete character/digit
                             if(app->edit_track_field == TRACK_FIELD_DURATION) {
                                 // Delete last digit
-                                int32_t current_seconds = 0;
-                                if(strlen(track->duration) > 0) {
-                                    current_seconds = atoi(track->duration);
-                                }
-                                current_seconds = current_seconds / 10;
-                                if(current_seconds > 0) {
-                                    snprintf(track->duration, sizeof(track->duration), "%ld", (long)current_seconds);
-                                } else {
-                                    track->duration[0] = '\0';
-                                }
-                                app->dirty = true;
+                                track->duration = track->duration / 10;
+                                flipchanger_mark_tracks_dirty(app);
                             } else {
                                 // Delete character in title
                                 int32_t len = strlen(field);
@@ -1898,11 +3475,16 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                                     }
                                     app->edit_char_pos--;
                                 }
-                                app->dirty = true;
+                                flipchanger_mark_tracks_dirty(app);
                             }
                         }
                     }
                 }
+                
+                if(field == title &&
+                   strcmp(title, track_list_title(tracks, app->edit_selected_track)) != 0) {
+                    track_list_set_title(tracks, app->edit_selected_track, title);
+                }
             } else {
                 // Track list navigation
                 if(input_event->key == InputKeyUp) {
@@ -1923,17 +3505,17 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                     }
                 } else if(input_event->key == InputKeyRight) {
                     // Add new track
-                    if(slot->cd.track_count >= 0 && slot->cd.track_count < MAX_TRACKS) {
-                        Track* new_track = &slot->cd.tracks[slot->cd.track_count];
-                        if(new_track) {
-                            new_track->number = slot->cd.track_count + 1;
-                            new_track->title[0] = '\0';
-                            new_track->duration[0] = '\0';
+                    if(slot->cd.track_count < MAX_TRACKS) {
+                        // Drop anything past the count before appending after it
+                        while(tracks->count > slot->cd.track_count) {
+                            track_list_remove(tracks, tracks->count - 1);
+                        }
+                        if(track_list_append(tracks, slot->cd.track_count + 1, "", 0)) {
                             slot->cd.track_count++;
-                            if(slot->cd.track_count > MAX_TRACKS) slot->cd.track_count = MAX_TRACKS;
                             app->edit_selected_track = slot->cd.track_count - 1;
                             if(app->edit_selected_track < 0) app->edit_selected_track = 0;
-                            app->dirty = true;
+                            flipchanger_mark_dirty(app, app->current_slot_index);
+                            flipchanger_mark_tracks_dirty(app);
                             if(app->notifications) {
                                 notification_message(app->notifications, &sequence_blink_blue_100);
                             }
@@ -1941,21 +3523,19 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
                     }
                 } else if(input_event->key == InputKeyLeft) {
                     // Delete selected track
-                    if(slot->cd.track_count > 0 && app->edit_selected_track >= 0 && app->edit_selected_track < slot->cd.track_count && app->edit_selected_track < MAX_TRACKS) {
-                        // Shift tracks down
-                        for(int32_t i = app->edit_selected_track; i < slot->cd.track_count - 1 && i < MAX_TRACKS - 1; i++) {
-                            if(i + 1 < MAX_TRACKS) {
-                                slot->cd.tracks[i] = slot->cd.tracks[i + 1];
-                                slot->cd.tracks[i].number = i + 1;
-                            }
+                    if(slot->cd.track_count > 0 && app->edit_selected_track >= 0 && app->edit_selected_track < slot->cd.track_count) {
+                        // Later tracks move up and are renumbered
+                        track_list_remove(tracks, app->edit_selected_track);
+                        for(int32_t i = app->edit_selected_track; i < tracks->count; i++) {
+                            tracks->tracks[i].number = i + 1;
                         }
                         slot->cd.track_count--;
-                        if(slot->cd.track_count < 0) slot->cd.track_count = 0;
                         if(app->edit_selected_track >= slot->cd.track_count && app->edit_selected_track > 0) {
                             app->edit_selected_track--;
                         }
                         if(app->edit_selected_track < 0) app->edit_selected_track = 0;
-                        app->dirty = true;
+                        flipchanger_mark_dirty(app, app->current_slot_index);
+                        flipchanger_mark_tracks_dirty(app);
                         if(app->notifications) {
                             notification_message(app->notifications, &sequence_blink_red_100);
                         }
@@ -1991,8 +3571,114 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
             break;
         }
         
-        case VIEW_STATISTICS: {
+        case VIEW_SEARCH: {
+            // Results shown while the worker narrows them are not final - wait to pick one
+            bool final = app->search_results && !app->search_stale && !app->search_running;
+            int32_t result_count = final ? app->search_results->count : 0;
             if(input_event->key == InputKeyBack) {
+                if(is_long_press) {
+                    app->running = false;
+                    return;
+                } else if(app->search_focus_results) {
+                    app->search_focus_results = false;
+                } else {
+                    flipchanger_show_main_menu(app);
+                }
+            } else if(app->search_focus_results) {
+                // Results - pick one to open
+                if(input_event->key == InputKeyUp) {
+                    if(app->search_selected > 0) {
+                        app->search_selected--;
+                        if(app->search_selected < app->search_scroll) {
+                            app->search_scroll = app->search_selected;
+                        }
+                    }
+                } else if(input_event->key == InputKeyDown) {
+                    if(app->search_selected < result_count - 1) {
+                        app->search_selected++;
+                        if(app->search_selected >= app->search_scroll + SEARCH_VISIBLE_RESULTS) {
+                            app->search_scroll = app->search_selected - SEARCH_VISIBLE_RESULTS + 1;
+                        }
+                    }
+                } else if(input_event->key == InputKeyLeft) {
+                    app->search_focus_results = false;
+                } else if(input_event->key == InputKeyOk && app->search_selected < result_count) {
+                    int32_t slot_index = app->search_results->match[app->search_selected].slot_index;
+                    flipchanger_update_cache(app, slot_index);
+                    flipchanger_show_slot_details(app, slot_index);
+                    app->details_from_search = true;
+                }
+            } else {
+                // Query - same character picker as the edit view, OK adds the character (or DEL)
+                if(input_event->key == InputKeyUp) {
+                    app->edit_char_selection =
+                        app->edit_char_selection > 0 ? app->edit_char_selection - 1 : CHAR_DEL_INDEX;
+                } else if(input_event->key == InputKeyDown) {
+                    app->edit_char_selection =
+                        app->edit_char_selection < CHAR_DEL_INDEX ? app->edit_char_selection + 1 : 0;
+                } else if(input_event->key == InputKeyOk) {
+                    int32_t len = strlen(app->search_query);
+                    if(app->edit_char_selection >= CHAR_DEL_INDEX) {
+                        if(len > 0) {
+                            app->search_query[len - 1] = '\0';
+                            flipchanger_search_changed(app, false);
+                        }
+                    } else if(len < SEARCH_QUERY_LENGTH - 1) {
+                        app->search_query[len] = CHAR_SET[app->edit_char_selection];
+                        app->search_query[len + 1] = '\0';
+                        flipchanger_search_changed(app, true);
+                    }
+                } else if(input_event->key == InputKeyRight && result_count > 0) {
+                    app->search_focus_results = true;
+                }
+            }
+            break;
+        }
+        
+        case VIEW_FILTER: {
+            if(input_event->key == InputKeyUp) {
+                if(app->selected_index > 0) {
+                    app->selected_index--;
+                    if(app->selected_index < app->scroll_offset) {
+                        app->scroll_offset = app->selected_index;
+                    }
+                }
+            } else if(input_event->key == InputKeyDown) {
+                if(app->selected_index < flipchanger_filter_row_count(app) - 1) {
+                    app->selected_index++;
+                    if(app->selected_index >= app->scroll_offset + FILTER_VISIBLE_ROWS) {
+                        app->scroll_offset = app->selected_index - FILTER_VISIBLE_ROWS + 1;
+                    }
+                }
+            } else if(input_event->key == InputKeyOk) {
+                FilterRowType type;
+                int32_t value;
+                if(flipchanger_filter_row(app, app->selected_index, &type, &value)) {
+                    flipchanger_filter_toggle(app, type, value);
+                }
+            } else if(input_event->key == InputKeyBack) {
+                if(is_long_press) {
+                    app->running = false;
+                    return;
+                } else {
+                    // Straight to the slots that pass
+                    flipchanger_show_slot_list(app);
+                }
+            }
+            break;
+        }
+        
+        case VIEW_STATISTICS: {
+            if(input_event->key == InputKeyUp) {
+                if(app->details_scroll_offset > 0) {
+                    app->details_scroll_offset--;
+                }
+            } else if(input_event->key == InputKeyDown) {
+                if(app->details_scroll_offset + STATS_VISIBLE_LINES <
+                   flipchanger_stats_line_count(app)) {
+                    app->details_scroll_offset++;
+                }
+            } else if(input_event->key == InputKeyBack) {
                 if(is_long_press) {
                     app->running = false;
                     return;
@@ -2006,11 +3692,20 @@ void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
         default:
             break;
     }
+}
+
+// Input callback (input service thread) - only queues the event for the app thread
+void flipchanger_input_callback(InputEvent* input_event, void* ctx) {
+    FlipChangerApp* app = (FlipChangerApp*)ctx;
     
-    // Only update if app is still running
-    if(app->running && app->view_port) {
-        view_port_update(app->view_port);
+    // Safety check - don't queue input if app is exiting
+    if(!app || !app->running) {
+        return;
     }
+    
+    // Runs on the input service thread - never block it, a full queue drops the key
+    FlipChangerEvent event = {.type = FlipChangerEventTypeInput, .input = *input_event};
+    furi_message_queue_put(app->event_queue, &event, 0);
 }
 
 // Main entry point
@@ -2027,6 +3722,19 @@ int32_t flipchanger_main(void* p) {
     app->notifications = furi_record_open(RECORD_NOTIFICATION);
     app->running = true;
     app->dirty = false;
+    app->tracks_slot_index = -1;
+    app->slot_read_failed = -1;
+    app->list_count = -1;
+    app->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    app->event_queue = furi_message_queue_alloc(EVENT_QUEUE_SIZE, sizeof(FlipChangerEvent));
+    
+    // Load data before the view port is attached - draw never runs while the card is busy
+    // (and the storage worker only starts once nothing else touches the card)
+    flipchanger_load_data(app);
+    app->worker = flipchanger_worker_alloc(app);
+    
+    // Start with main menu
+    flipchanger_show_main_menu(app);
     
     // Create view port
     app->view_port = view_port_alloc();
@@ -2036,19 +3744,45 @@ int32_t flipchanger_main(void* p) {
     // Attach view port to GUI
     gui_add_view_port(app->gui, app->view_port, GuiLayerFullscreen);
     
-    // Load data
-    flipchanger_load_data(app);
-    
     // Send notification that app started
     notification_message(app->notifications, &sequence_blink_green_100);
     
-    // Start with main menu
-    flipchanger_show_main_menu(app);
+    // First frame
+    flipchanger_capture_view_state(app, &app->drawn_state);
     view_port_update(app->view_port);
     
-    // Main event loop
+    // Main event loop - sleeps until input arrives or the storage worker finishes a request
+    FlipChangerEvent event;
     while(app->running) {
-        furi_delay_ms(100);
+        if(furi_message_queue_get(app->event_queue, &event, FuriWaitForever) != FuriStatusOk) {
+            continue;
+        }
+        
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        if(event.type == FlipChangerEventTypeInput) {
+            flipchanger_handle_input(app, &event.input);
+        } else {
+            flipchanger_handle_storage_event(app, &event);
+        }
+        if(app->storage_event_missed) {
+            app->storage_event_missed = false;
+            FlipChangerEvent missed = {.type = FlipChangerEventTypeStorage};
+            flipchanger_handle_storage_event(app, &missed);
+        }
+        flipchanger_sync_tracks(app);
+        flipchanger_sync_search(app);
+        flipchanger_check_redraw(app);
+        bool redraw = app->redraw_pending &&
+                      furi_message_queue_get_count(app->event_queue) == 0;
+        if(redraw) {
+            app->redraw_pending = false;
+        }
+        furi_mutex_release(app->mutex);
+        
+        // One update once queued events are drained (key repeat collapses into a single frame)
+        if(app->running && redraw) {
+            view_port_update(app->view_port);
+        }
     }
     
     // Exit cleanup sequence (must be in exact order to prevent crashes)
@@ -2067,9 +3801,40 @@ int32_t flipchanger_main(void* p) {
     // 3. Set running to false after view port is removed (redundant but safe)
     app->running = false;
     
-    // 4. Save data NOW (view port removed, but storage/GUI still valid)
-    if(app->dirty && app->storage) {
-        flipchanger_save_data(app);
+    FURI_LOG_I(
+        TAG,
+        "Slot cache: %lu hits, %lu misses",
+        (unsigned long)app->cache_hits,
+        (unsigned long)app->cache_misses);
+    
+    // 4. Save data NOW (view port removed, but storage/GUI still valid) - queue unsaved
+    // slots, the JSON export and journal compaction, then let the worker drain the queue
+    if(app->worker) {
+        // Cache state is the mutex's like everywhere else (the worker still hands results
+        // over under it) - a full queue is waited out with the mutex released, so the worker
+        // can finish what it holds
+        while(true) {
+            furi_mutex_acquire(app->mutex, FuriWaitForever);
+            bool queued = flipchanger_tracks_write_back(app, 0) &&
+                          flipchanger_write_back_cache(app, 0);
+            furi_mutex_release(app->mutex);
+            if(queued) {
+                break;
+            }
+            furi_delay_ms(STORAGE_RETRY_MS);
+        }
+        StorageRequest flush = {.type = StorageRequestFlush};
+        flipchanger_worker_post(app->worker, &flush, FuriWaitForever);
+        StorageRequest compact = {.type = StorageRequestCompact};
+        flipchanger_worker_post(app->worker, &compact, FuriWaitForever);
+        flipchanger_worker_free(app->worker);
+        app->worker = NULL;
+    }
+    
+    // 4b. Close the database (before storage record is released)
+    if(app->db) {
+        flipchanger_db_free(app->db);
+        app->db = NULL;
     }
     
     // 5. Free view port
@@ -2097,6 +3862,11 @@ int32_t flipchanger_main(void* p) {
     }
     
     // 9. Free app structure
+    flipchanger_free_cache(app);
+    track_list_free(app->tracks);
+    free(app->search_results);
+    furi_message_queue_free(app->event_queue);
+    furi_mutex_free(app->mutex);
     free(app);
     
     return 0;
@@ -2122,22 +3892,141 @@ void flipchanger_draw_settings(Canvas* canvas, FlipChangerApp* app) {
     canvas_draw_str(canvas, 5, 63, "LB:Exit");
 }
 
-// Draw Statistics view (stub)
+// Draw Statistics view - straight from the running totals, no slot is read
 void flipchanger_draw_statistics(Canvas* canvas, FlipChangerApp* app) {
-    UNUSED(app);
     canvas_clear(canvas);
     canvas_set_font(canvas, FontPrimary);
     
     // Title
     canvas_draw_str(canvas, 20, 10, "Statistics");
     
+    // Show a few lines at a time with scrolling
     canvas_set_font(canvas, FontSecondary);
-    canvas_draw_str(canvas, 5, 30, "Coming Soon");
-    canvas_draw_str(canvas, 5, 40, "Statistics view");
-    canvas_draw_str(canvas, 5, 50, "will be here");
+    char line[STATS_LINE_LENGTH];
+    int32_t y = 21;
+    for(int32_t i = 0; i < STATS_VISIBLE_LINES; i++) {
+        if(!flipchanger_stats_line(app, app->details_scroll_offset + i, line, sizeof(line))) {
+            break;
+        }
+        canvas_draw_str(canvas, 5, y, line);
+        y += 9;
+    }
     
     // Footer - two lines with abbreviations
     canvas_set_font(canvas, FontKeyboard);
-    canvas_draw_str(canvas, 5, 57, "B:Return");
+    canvas_draw_str(canvas, 5, 57, "U/D:Scroll B:Return");
+    canvas_draw_str(canvas, 5, 63, "LB:Exit");
+}
+
+// Draw Filter view - facet values to pick, and how many slots pass (bit operations only)
+void flipchanger_draw_filter(Canvas* canvas, FlipChangerApp* app) {
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontPrimary);
+    
+    // Title with the slots that pass
+    uint32_t bits[SLOT_BITMAP_WORDS];
+    flipchanger_filter_slots(app, bits);
+    int32_t passing = 0;
+    for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+        passing += __builtin_popcount(bits[w]);
+    }
+    char line[FILTER_ROW_LENGTH];
+    snprintf(line, sizeof(line), "Filter: %ld slots", (long)passing);
+    canvas_draw_str(canvas, 5, 10, line);
+    
+    canvas_set_font(canvas, FontSecondary);
+    int32_t y = 21;
+    for(int32_t i = app->scroll_offset; i < app->scroll_offset + FILTER_VISIBLE_ROWS; i++) {
+        FilterRowType type;
+        int32_t value;
+        if(!flipchanger_filter_row(app, i, &type, &value)) {
+            break;
+        }
+        flipchanger_filter_row_text(app, type, value, line, sizeof(line));
+        if(i == app->selected_index) {
+            canvas_draw_box(canvas, 2, y - 8, 124, 9);
+            canvas_invert_color(canvas);
+        }
+        canvas_draw_str(canvas, 5, y, line);
+        if(i == app->selected_index) {
+            canvas_invert_color(canvas);
+        }
+        y += 9;
+    }
+    
+    // Footer - two lines with abbreviations
+    canvas_set_font(canvas, FontKeyboard);
+    canvas_draw_str(canvas, 5, 57, "U/D:Nav K:Pick B:Show");
     canvas_draw_str(canvas, 5, 63, "LB:Exit");
 }
+
+// Draw Search view - query with the character picker, then the results
+void flipchanger_draw_search(Canvas* canvas, FlipChangerApp* app) {
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontPrimary);
+    
+    // Query (last characters if it is long) and the picker
+    size_t len = strlen(app->search_query);
+    const char* shown = len > SEARCH_VISIBLE_QUERY ? app->search_query + len - SEARCH_VISIBLE_QUERY :
+                                                      app->search_query;
+    char line[48];
+    snprintf(line, sizeof(line), "Find:%s%s", shown, app->search_focus_results ? "" : "_");
+    canvas_draw_str(canvas, 2, 10, line);
+    if(!app->search_focus_results) {
+        char picker[8];
+        if(app->edit_char_selection >= CHAR_DEL_INDEX) {
+            snprintf(picker, sizeof(picker), "[DEL]");
+        } else {
+            snprintf(picker, sizeof(picker), "[%c]", CHAR_SET[app->edit_char_selection]);
+        }
+        canvas_draw_str(canvas, 98, 10, picker);
+    }
+    
+    canvas_set_font(canvas, FontSecondary);
+    const SearchResults* results = app->search_results;
+    if(len < SEARCH_MIN_QUERY) {
+        canvas_draw_str(canvas, 5, 30, "Type 3 or more characters");
+    } else if(!results || (results->count == 0 && (app->search_stale || app->search_running))) {
+        canvas_draw_str(canvas, 5, 30, "Searching...");
+    } else if(results->count == 0) {
+        canvas_draw_str(canvas, 5, 30, "No matches");
+    } else {
+        // Slot number, then the artist/album or "#track title" that matched
+        int32_t y = 21;
+        for(int32_t i = app->search_scroll;
+            i < results->count && i < app->search_scroll + SEARCH_VISIBLE_RESULTS;
+            i++) {
+            const SearchMatch* match = &results->match[i];
+            if(match->track == SEARCH_NO_TRACK) {
+                snprintf(line, sizeof(line), "%d: %s", match->slot_index + 1, match->text);
+            } else {
+                snprintf(
+                    line,
+                    sizeof(line),
+                    "%d: #%d %s",
+                    match->slot_index + 1,
+                    match->track + 1,
+                    match->text);
+            }
+            bool selected = app->search_focus_results && i == app->search_selected;
+            if(selected) {
+                canvas_draw_box(canvas, 2, y - 8, 124, 9);
+                canvas_invert_color(canvas);
+            }
+            canvas_draw_str(canvas, 5, y, line);
+            if(selected) {
+                canvas_invert_color(canvas);
+            }
+            y += 10;
+        }
+    }
+    
+    // Footer - two lines with abbreviations
+    canvas_set_font(canvas, FontKeyboard);
+    if(app->search_focus_results) {
+        canvas_draw_str(canvas, 5, 57, "U/D:Nav K:View L:Query");
+    } else {
+        canvas_draw_str(canvas, 5, 57, "U/D:Char K:Add R:Results");
+    }
+    canvas_draw_str(canvas, 5, 63, "B:Return LB:Exit");
+}
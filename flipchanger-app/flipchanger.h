@@ -15,63 +15,210 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "flipchanger_tracks.h"  // Track, TrackList, MAX_TRACKS
+#include "flipchanger_search.h"  // SearchResults, SEARCH_QUERY_LENGTH
+#include "flipchanger_strings.h" // STRING_TABLE_MAX_ENTRIES
+
 // Maximum number of slots (CDs) - stored on SD card
 #define MAX_SLOTS 200
 #define MIN_SLOTS 3
 #define DEFAULT_SLOTS 100  // Default number of slots
+#define SLOT_BITMAP_WORDS ((MAX_SLOTS + 31) / 32)  // One bit per slot
+
+// Memory cache - full slot bodies are only kept for the slot on screen and a few ahead of it
+// (lists draw from the resident summaries)
+#define SLOT_CACHE_SIZE 4  // Slot bodies in RAM at a time (~420 bytes each - tracks live apart)
+
+// Prefetch while scrolling the slot list (stays below SLOT_CACHE_SIZE)
+#define PREFETCH_PAGE 2        // Slots loaded ahead of a normal scroll
+#define PREFETCH_FAST_PAGE 3   // Slots loaded ahead of a held key or rapid presses
+#define PREFETCH_FAST_MS 300   // Moves closer together than this count as rapid
 
-// Memory cache - only keep visible slots in RAM
-#define SLOT_CACHE_SIZE 10  // Only keep 10 slots in memory at a time
+// Jumps while Left/Right is held in the slot list (artist order jumps by initial instead)
+#define LIST_PAGE 10        // Rows per jump when the hold registers
+#define LIST_FAST_PAGE 25   // Rows per jump once the hold repeats
+
+// Events waiting for the app thread (input + storage completions)
+#define EVENT_QUEUE_SIZE 16
+
+// Saves queued at exit - a full storage queue is tried again after this long
+#define STORAGE_RETRY_MS 10
 
 // Maximum string lengths
 #define MAX_STRING_LENGTH 64
 #define MAX_ARTIST_LENGTH 64
 #define MAX_ALBUM_LENGTH 64
 #define MAX_GENRE_LENGTH 32
-#define MAX_TRACK_TITLE_LENGTH 64
 #define MAX_NOTES_LENGTH 256
-#define MAX_TRACKS 20  // Reduced for memory - can increase later
 
 // File path for data storage
 #define FLIPCHANGER_DATA_PATH "/ext/apps/Tools/flipchanger_data.json"
+#define FLIPCHANGER_INDEX_PATH "/ext/apps/Tools/flipchanger_data.idx"  // Slot offsets into the JSON
+#define FLIPCHANGER_DATA_TMP_PATH "/ext/apps/Tools/flipchanger_data.json.tmp"  // Save in progress
+#define FLIPCHANGER_DATA_BAK_PATH "/ext/apps/Tools/flipchanger_data.json.bak"  // Previous save
 
-// Track information
-typedef struct {
-    int32_t number;
-    char title[MAX_TRACK_TITLE_LENGTH];
-    char duration[16];  // Format: "3:45"
-} Track;
-
-// CD information
+// CD information (tracks are in the slot's TrackList)
 typedef struct {
     char artist[MAX_ARTIST_LENGTH];
     char album[MAX_ALBUM_LENGTH];
-    int32_t year;
     char genre[MAX_GENRE_LENGTH];
-    Track tracks[MAX_TRACKS];
-    int32_t track_count;
     char notes[MAX_NOTES_LENGTH];
+    uint16_t year;        // 0 = unknown
+    uint8_t track_count;  // Up to MAX_TRACKS
 } CD;
 
 // Slot information
 typedef struct {
-    int32_t slot_number;
-    bool occupied;
+    uint8_t slot_number;  // 1-MAX_SLOTS (0 = invalid)
+    bool occupied : 1;
     CD cd;
 } Slot;
 
+// Cache entry - one full slot, least recently used is evicted first
+typedef struct {
+    int32_t slot_index;  // -1 = unused
+    uint32_t last_used;  // Cache clock at last access
+    bool dirty;          // Modified since loaded/saved - written back on eviction
+    bool loading;        // Reserved, storage worker has not filled it yet
+    Slot* slot;          // Body - allocated on first use, reused after eviction
+} SlotCacheEntry;
+
+// Slot summary - kept in RAM for every slot (list rows, counts, statistics)
+#define SUMMARY_TEXT_LENGTH 20  // Album prefix kept in the summary
+
+typedef struct {
+    char album[SUMMARY_TEXT_LENGTH];
+    uint16_t artist;  // String table ids - equal names have equal ids
+    uint16_t genre;
+    uint16_t year;
+    uint16_t length;      // Playing time in seconds (capped at UINT16_MAX)
+    uint8_t track_count;
+} SlotSummary;
+
+// Search session (storage worker) - slots that may match each length of the query typed so
+// far. A character typed only rechecks the slots left by the shorter query, and DEL goes back
+// to a level that is already built
+#define SEARCH_LEVELS (SEARCH_QUERY_LENGTH - SEARCH_MIN_QUERY)  // One per query length (fits levels)
+#define SEARCH_SCAN_MIN_CANDIDATES 16  // Fewer are checked without scanning the signatures
+
+typedef struct {
+    char query[SEARCH_QUERY_LENGTH];  // Every level is for a prefix of this
+    uint32_t levels;                  // Bit n = level of length SEARCH_MIN_QUERY + n is built
+    uint32_t text[SEARCH_LEVELS][SLOT_BITMAP_WORDS];    // Artist/album may match
+    uint32_t tracks[SEARCH_LEVELS][SLOT_BITMAP_WORDS];  // A track title may match
+} SearchSession;
+
+// Running collection totals (see flipchanger_stats.h)
+typedef struct CollectionStats CollectionStats;
+
+// Browse orders of the slot list - every order but slot number has a sort index
+typedef enum {
+    SortBySlot,    // Slot number - every slot
+    SortByArtist,  // Then album
+    SortByAlbum,   // Then artist (album as kept in the summary)
+    SortByYear,    // Oldest first, no year last - then artist, album
+    SortByGenre,   // Then artist, album
+    SortByCount,
+} SortOrder;
+
+// Occupied slots in each browse order (see flipchanger_sort.h)
+typedef struct SortIndexes SortIndexes;
+
+// Slots of each decade and genre (see flipchanger_facets.h)
+typedef struct FacetIndex FacetIndex;
+
+#define FILTER_GENRE_WORDS ((STRING_TABLE_MAX_ENTRIES + 31) / 32)  // One bit per genre id
+
+// Binary slot database (see flipchanger_db.h)
+typedef struct FlipChangerDb FlipChangerDb;
+
+// Storage worker thread (see flipchanger_worker.h)
+typedef struct FlipChangerWorker FlipChangerWorker;
+
+typedef enum {
+    StorageRequestLoad,     // Read slot into its reserved cache entry
+    StorageRequestSave,     // Journal a slot
+    StorageRequestLoadTracks,  // Read track list into app->tracks
+    StorageRequestSaveTracks,  // Journal a track list
+    StorageRequestSearch,   // Search every slot for a query into app->search_results
+    StorageRequestFlush,    // Export JSON if anything changed
+    StorageRequestCompact,  // Fold the journal into the database
+    StorageRequestStop,
+} StorageRequestType;
+
+// App thread event - input, or a finished storage request
+typedef enum {
+    FlipChangerEventTypeInput,
+    FlipChangerEventTypeStorage,
+} FlipChangerEventType;
+
+typedef struct {
+    FlipChangerEventType type;
+    union {
+        InputEvent input;
+        struct {
+            StorageRequestType request;
+            int32_t slot_index;
+            bool result;
+        } storage;
+    };
+} FlipChangerEvent;
+
+// Everything a frame is drawn from - compared after each event so inputs that change
+// nothing on screen cost no redraw
+typedef struct {
+    int32_t view;
+    int32_t selected_index;
+    int32_t scroll_offset;
+    int32_t sort_order;
+    int32_t current_slot_index;
+    int32_t details_scroll_offset;
+    int32_t edit_field;
+    int32_t edit_char_pos;
+    int32_t edit_char_selection;
+    int32_t edit_field_scroll;
+    int32_t edit_selected_track;
+    int32_t editing_track;
+    int32_t edit_track_field;
+    int32_t search_selected;
+    int32_t search_scroll;
+    int32_t search_focus_results;
+    uint32_t search_hash;  // Query being typed
+    uint32_t filter_hash;  // Slot list filter
+    int32_t read_failed;  // Slot whose load failed - shown as an error until a retry
+    int32_t tracks_failed;  // Same for the track list
+    uint32_t generation;  // Storage worker hand-overs (loaded slots, updated summaries)
+    uint32_t slot_hash;   // Slot (and track list) on screen - edits change them in place
+} FlipChangerViewState;
+
+// What the slot list rows were built from - they are rebuilt once any of it changes
+typedef struct {
+    uint32_t generation;  // Summaries (bumped with every hand-over that changes them)
+    int32_t total_slots;
+    int32_t sort_order;
+    bool filter_occupied;
+    uint32_t filter_decades;
+    uint32_t filter_genres[FILTER_GENRE_WORDS];
+} FlipChangerListKey;
+
 // Application state
 typedef struct {
     Gui* gui;
     ViewPort* view_port;
     NotificationApp* notifications;
     Storage* storage;
+    FuriMessageQueue* event_queue;  // FlipChangerEvents for the app thread
+    FlipChangerDb* db;              // Only the storage worker does I/O on it once running
+    FlipChangerWorker* worker;
     
     // Data - only cache a few slots in memory, rest on SD card
-    Slot slots[SLOT_CACHE_SIZE];  // Cache for visible slots
+    SlotCacheEntry cache[SLOT_CACHE_SIZE];  // LRU cache of full slot bodies
+    uint32_t cache_clock;        // Bumped on every cache access
+    uint32_t cache_hits;         // flipchanger_update_cache served from RAM
+    uint32_t cache_misses;       // flipchanger_update_cache had to read the SD card
+    int32_t slot_read_failed;    // Slot whose last load failed (-1 = none) - shown as an error, never as empty
     int32_t total_slots;
     int32_t current_slot_index;  // Currently viewing/editing
-    int32_t cache_start_index;   // First cached slot index
     
     // UI State
     enum {
@@ -82,15 +229,21 @@ typedef struct {
         VIEW_TRACK_MANAGEMENT,
         VIEW_SETTINGS,
         VIEW_STATISTICS,
+        VIEW_SEARCH,
+        VIEW_FILTER,
         VIEW_CONFIRM_DELETE,
     } current_view;
     
     int32_t details_scroll_offset;  // Scroll offset for slot details view
     
-    int32_t selected_index;      // Selected item in list
+    int32_t selected_index;      // Selected item in list (a row of the slot list, not a slot)
     int32_t scroll_offset;        // Scroll position in lists
+    SortOrder sort_order;         // Slot list order
     bool running;
-    bool dirty;                   // Data has been modified, needs save
+    FuriMutex* mutex;             // Guards app state - held by input handling, draw and worker hand-over
+    bool dirty;                   // A cached slot has been modified, needs save
+    bool export_pending;          // Database has changes not yet exported to JSON (worker only)
+    bool import_partial;          // JSON did not parse in full - it is never exported over
     
     // Add/Edit Input State
     enum {
@@ -116,6 +269,47 @@ typedef struct {
         TRACK_FIELD_COUNT
     } edit_track_field;            // Which track field is being edited
     
+    // Track list of the slot in VIEW_TRACK_MANAGEMENT (loaded on entry, freed on exit)
+    // Stored and loaded apart from the slot - only the track view needs it
+    TrackList* tracks;             // NULL while no track view is open
+    int32_t tracks_slot_index;     // Slot the list belongs to
+    bool tracks_loading;           // Storage worker has not filled it yet
+    bool tracks_requested;         // Load is queued (false = retry after next storage event)
+    bool tracks_failed;            // Load failed - shown as an error until OK retries it
+    bool tracks_dirty;             // Modified since loaded/saved - saved on leaving the view
+    
+    // Search State (VIEW_SEARCH) - results are filled by the storage worker
+    char search_query[SEARCH_QUERY_LENGTH];
+    SearchResults* search_results; // NULL unless the search view (or a slot opened from it) is open
+    bool search_stale;             // Query changed since the last search was queued
+    bool search_running;           // Search for the current query is queued
+    bool search_focus_results;     // Up/Down move through the results instead of the picker
+    int32_t search_selected;       // Selected result
+    int32_t search_scroll;
+    bool details_from_search;      // Slot details return to the search view
+    SearchSession* search_session; // Storage worker only - levels of the last query searched
+    
+    // Slot list filter (VIEW_FILTER) - values of one facet OR together, facets AND together
+    bool filter_occupied;                        // Occupied slots only
+    uint32_t filter_decades;                     // Bit n = facet decade n (see flipchanger_facets.h)
+    uint32_t filter_genres[FILTER_GENRE_WORDS];  // Bit n = genre id n + 1
+    
+    // Slot list rows (under mutex) - built once per change of list_key, so row lookups in
+    // draw never go back to the facets or the sort indexes
+    FlipChangerListKey list_key;
+    uint8_t list_slots[MAX_SLOTS];               // Slot of each row
+    int32_t list_count;                          // Rows, -1 until first built
+    
+    // Prefetch State (loads are queued to the storage worker)
+    int32_t scroll_direction;      // +1 down, -1 up
+    uint32_t last_scroll_tick;     // Tick of the previous list move
+    
+    // Redraw State (app thread, under mutex)
+    FlipChangerViewState drawn_state;  // State as of the last view_port_update
+    uint32_t view_generation;          // Bumped when the worker changes what views show
+    bool storage_event_missed;         // A completion found the event queue full
+    bool redraw_pending;               // Visible state changed, update once the queue drains
+    
 } FlipChangerApp;
 
 // Function declarations
@@ -124,6 +318,44 @@ int32_t flipchanger_main(void* p);
 // Storage functions
 bool flipchanger_load_data(FlipChangerApp* app);
 bool flipchanger_save_data(FlipChangerApp* app);
+bool flipchanger_save_slot_to_sd(FlipChangerApp* app, int32_t slot_index);
+
+// Storage worker side (SD I/O - app->mutex is only taken to hand results over)
+bool flipchanger_read_slot(FlipChangerApp* app, int32_t slot_index, Slot* slot);
+bool flipchanger_write_slot(FlipChangerApp* app, int32_t slot_index, const Slot* slot);
+void flipchanger_install_slot(FlipChangerApp* app, int32_t slot_index, const Slot* slot);  // NULL = read failed
+bool flipchanger_read_tracks(FlipChangerApp* app, int32_t slot_index, TrackList* tracks);
+bool flipchanger_write_tracks(FlipChangerApp* app, int32_t slot_index, const TrackList* tracks);
+void flipchanger_install_tracks(FlipChangerApp* app, int32_t slot_index, const TrackList* tracks);  // NULL = read failed
+bool flipchanger_search(FlipChangerApp* app, const char* query, SearchResults* results);
+void flipchanger_install_search(FlipChangerApp* app, const char* query, const SearchResults* results);
+
+// Cache functions
+Slot* flipchanger_get_slot(FlipChangerApp* app, int32_t slot_index);
+const char* flipchanger_slot_placeholder(FlipChangerApp* app, int32_t slot_index);
+void flipchanger_update_cache(FlipChangerApp* app, int32_t slot_index);
+void flipchanger_mark_dirty(FlipChangerApp* app, int32_t slot_index);
+
+// Track list of the track view (NULL until loaded - safe from draw)
+TrackList* flipchanger_get_tracks(FlipChangerApp* app);
+void flipchanger_mark_tracks_dirty(FlipChangerApp* app);
+
+// Summary functions (resident for all slots - never touch the SD card)
+const SlotSummary* flipchanger_get_summary(FlipChangerApp* app, int32_t slot_index);
+const char* flipchanger_get_string(FlipChangerApp* app, uint16_t id);
+const CollectionStats* flipchanger_get_stats(FlipChangerApp* app);
+bool flipchanger_is_occupied(FlipChangerApp* app, int32_t slot_index);
+
+// Slot list rows in app->sort_order - every slot by number, the occupied ones in any other
+// order (from the sort indexes - never touch the SD card). Slot/row is -1 if there is none
+int32_t flipchanger_list_count(FlipChangerApp* app);
+int32_t flipchanger_list_slot(FlipChangerApp* app, int32_t row);
+int32_t flipchanger_list_row(FlipChangerApp* app, int32_t slot_index);
+
+// Slots passing the slot list filter (one bit per slot in SLOT_BITMAP_WORDS words - all of
+// them when no filter is set). Bit operations on the facet bitsets only
+bool flipchanger_filter_active(FlipChangerApp* app);
+void flipchanger_filter_slots(FlipChangerApp* app, uint32_t* bits);
 
 // UI functions
 void flipchanger_draw_callback(Canvas* canvas, void* ctx);
@@ -138,6 +370,8 @@ void flipchanger_show_main_menu(FlipChangerApp* app);
 void flipchanger_show_slot_list(FlipChangerApp* app);
 void flipchanger_show_slot_details(FlipChangerApp* app, int32_t slot_index);
 void flipchanger_show_add_edit(FlipChangerApp* app, int32_t slot_index, bool is_new);
+void flipchanger_show_search(FlipChangerApp* app);
+void flipchanger_show_filter(FlipChangerApp* app);
 
 // Utility functions
 void flipchanger_init_slots(FlipChangerApp* app, int32_t total_slots);
@@ -0,0 +1,1322 @@
+/**
+ * FlipChanger - Binary Slot Database
+ *
+ * Layout: [FlipChangerDbHeader][FlipChangerDbSummaries][Record 0]...[Record N-1]
+ * Records are slots with artist and genre replaced by string table ids; the
+ * header stores the record and summary sizes so a build with a different
+ * struct layout rejects (and rebuilds) the file. The summary section always
+ * describes the records; journaled edits are applied to the RAM copy on
+ * replay and written at compaction. The collection totals and sort indexes
+ * at its end move with every summary update, so they always describe the
+ * summaries.
+ *
+ * The string table lives in its own file, rewritten whole (through a
+ * temporary copy) whenever summaries are written. Names a journaled slot
+ * introduces are interned when its summary is updated, so they are in the
+ * table before compaction writes a record that refers to them; names no
+ * summary refers to any more are dropped when compaction starts; their pool
+ * bytes are reclaimed by the next intern once they outweigh the live names
+ * (interning runs at open or under the app mutex, so draws never see
+ * strings move).
+ *
+ * Track lists live in their own file so slot records stay small and tracks
+ * are only read when a track view opens. Lists vary in size, so that file is
+ * [FlipChangerTracksEntry 0]...[FlipChangerTracksEntry N-1] followed by
+ * encoded lists (track_list_encode) appended as they are written; each entry
+ * points at its slot's newest list. Compaction copies the live lists to a
+ * fresh file once superseded ones take up more room than they do.
+ *
+ * Search signatures (see flipchanger_search.h) live in a third file, one
+ * SearchSignature per slot at a fixed stride. Every record write and
+ * journal append (and journal replay) rewrites the half of the slot's
+ * signature it changed, so the signatures always describe the newest copy.
+ *
+ * Edits are appended to a journal ([FlipChangerJournalRecord][payload]...,
+ * the record magic says whether the payload is a Slot or an encoded list) and
+ * folded into the records by flipchanger_db_compact(). RAM maps of
+ * slot -> newest journal copy keep reads O(1) while the journal grows.
+ */
+
+#include "flipchanger_db.h"
+#include <storage/storage.h>
+#include <string.h>
+
+#define TAG "FlipChangerDb"
+
+#define FLIPCHANGER_DB_MAGIC 0x42444346  // "FCDB"
+#define FLIPCHANGER_DB_VERSION 9
+#define FLIPCHANGER_DB_OCCUPIED_WORDS SLOT_BITMAP_WORDS
+#define FLIPCHANGER_JOURNAL_MAGIC 0x4C4E4A46         // "FJNL" - Slot payload
+#define FLIPCHANGER_JOURNAL_TRACKS_MAGIC 0x52544A46  // "FJTR" - Encoded track list payload
+#define FLIPCHANGER_TRACKS_VACUUM_SIZE (8 * 1024)     // Superseded list bytes worth a rewrite
+#define FLIPCHANGER_STRINGS_SPARE 64                  // Compact once fewer string ids are left
+#define FLIPCHANGER_STRINGS_LIVE_WORDS ((STRING_TABLE_MAX_ENTRIES + 31) / 32)
+#define FLIPCHANGER_SEARCH_CHUNK 8                    // Signatures read at a time by a search
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint16_t total_slots;
+    uint16_t summary_size;
+    uint16_t tracks_size;   // Tracks file directory entry size
+    uint16_t stats_size;    // Collection totals size
+    uint16_t search_size;   // Search signature size
+    uint16_t sort_size;     // Sort indexes size
+    uint32_t source_size;   // Stamp of the JSON file this was built from
+    uint32_t source_mtime;
+} FlipChangerDbHeader;
+
+typedef struct {
+    uint32_t occupied[FLIPCHANGER_DB_OCCUPIED_WORDS];  // One bit per slot
+    SlotSummary summary[MAX_SLOTS];
+    CollectionStats stats;  // Totals over the occupied summaries
+    SortIndexes sort;       // Occupied slots in each browse order
+} FlipChangerDbSummaries;
+
+// Slot as stored - names are string table ids
+typedef struct {
+    char album[MAX_ALBUM_LENGTH];
+    char notes[MAX_NOTES_LENGTH];
+    uint16_t artist;
+    uint16_t genre;
+    uint16_t year;
+    uint8_t track_count;
+    uint8_t occupied;
+} FlipChangerDbRecord;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t slot_index;
+    uint16_t length;        // Payload size (sizeof(Slot) or the encoded list size)
+    uint32_t checksum;      // Of the payload - a torn tail record fails this
+} FlipChangerJournalRecord;
+
+typedef struct {
+    uint32_t offset;        // Encoded list in the tracks file
+    uint32_t length;        // 0 = no tracks
+} FlipChangerTracksEntry;
+
+struct FlipChangerDb {
+    Storage* storage;
+    File* file;
+    File* tracks;
+    File* search;
+    bool is_open;           // All three files
+    FlipChangerDbHeader header;
+
+    // Resident summary section and the names it refers to
+    FlipChangerDbSummaries summaries;
+    bool summaries_dirty;
+    FacetIndex facets;      // Derived from the summaries - never stored
+    StringTable* strings;
+    bool strings_dirty;
+
+    // Journal
+    File* journal;
+    bool journal_open;
+    uint32_t journal_size;
+    uint32_t journal_offset[MAX_SLOTS];         // Payload offset of newest slot copy (0 = none)
+    uint32_t tracks_journal_offset[MAX_SLOTS];  // Same for track lists
+};
+
+// Helper: FNV-1a checksum
+static uint32_t flipchanger_db_checksum(const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    uint32_t hash = 2166136261u;
+    for(size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Helper: Byte offset of a slot record
+static uint32_t flipchanger_db_record_offset(int32_t slot_index) {
+    return sizeof(FlipChangerDbHeader) + sizeof(FlipChangerDbSummaries) +
+           (uint32_t)slot_index * sizeof(FlipChangerDbRecord);
+}
+
+// Helper: Expand a stored record into a slot
+static void flipchanger_db_record_to_slot(
+    FlipChangerDb* db,
+    const FlipChangerDbRecord* record,
+    int32_t slot_index,
+    Slot* slot) {
+    memset(slot, 0, sizeof(Slot));
+    slot->slot_number = slot_index + 1;
+    slot->occupied = record->occupied != 0;
+    strncpy(slot->cd.artist, string_table_get(db->strings, record->artist), MAX_ARTIST_LENGTH - 1);
+    strncpy(slot->cd.album, record->album, MAX_ALBUM_LENGTH - 1);
+    strncpy(slot->cd.genre, string_table_get(db->strings, record->genre), MAX_GENRE_LENGTH - 1);
+    strncpy(slot->cd.notes, record->notes, MAX_NOTES_LENGTH - 1);
+    slot->cd.year = record->year;
+    slot->cd.track_count = record->track_count;
+}
+
+// Helper: Pack a slot into a stored record (its names were interned with its summary)
+static void flipchanger_db_slot_to_record(
+    FlipChangerDb* db,
+    const Slot* slot,
+    FlipChangerDbRecord* record) {
+    memset(record, 0, sizeof(FlipChangerDbRecord));
+    record->occupied = slot->occupied;
+    record->artist = string_table_find(db->strings, slot->cd.artist);
+    strncpy(record->album, slot->cd.album, MAX_ALBUM_LENGTH - 1);
+    record->genre = string_table_find(db->strings, slot->cd.genre);
+    strncpy(record->notes, slot->cd.notes, MAX_NOTES_LENGTH - 1);
+    record->year = slot->cd.year;
+    record->track_count = slot->cd.track_count;
+}
+
+// Helper: True if every name of slot is in the string table (a record can refer to it).
+// An empty slot has none - text left in it is never interned
+static bool flipchanger_db_names_interned(FlipChangerDb* db, const Slot* slot) {
+    if(!slot->occupied) {
+        return true;
+    }
+    return (!slot->cd.artist[0] || string_table_find(db->strings, slot->cd.artist)) &&
+           (!slot->cd.genre[0] || string_table_find(db->strings, slot->cd.genre));
+}
+
+bool flipchanger_db_update_summary(FlipChangerDb* db, int32_t slot_index, const Slot* slot) {
+    if(!db || slot_index < 0 || slot_index >= MAX_SLOTS) {
+        return false;
+    }
+
+    // Names first - a name the table has no room for would be stored as none
+    uint16_t strings = db->strings->used;
+    uint16_t artist = STRING_ID_NONE;
+    uint16_t genre = STRING_ID_NONE;
+    if(slot->occupied) {
+        artist = string_table_intern(db->strings, slot->cd.artist);
+        genre = string_table_intern(db->strings, slot->cd.genre);
+        if(db->strings->used != strings) {
+            db->strings_dirty = true;
+        }
+        if(!flipchanger_db_names_interned(db, slot)) {
+            FURI_LOG_E(TAG, "String table full, slot %ld not indexed", (long)(slot_index + 1));
+            return false;
+        }
+    }
+
+    SlotSummary* summary = &db->summaries.summary[slot_index];
+    uint32_t bit = 1u << (slot_index % 32);
+    if(db->summaries.occupied[slot_index / 32] & bit) {
+        collection_stats_remove(&db->summaries.stats, summary);
+        sort_indexes_remove(&db->summaries.sort, slot_index);
+        facet_index_remove(&db->facets, slot_index, summary);
+    }
+
+    // Playing time comes with the track list - it outlives edits that keep the tracks
+    uint16_t length = summary->length;
+    memset(summary, 0, sizeof(SlotSummary));
+    if(slot->occupied) {
+        db->summaries.occupied[slot_index / 32] |= bit;
+        summary->artist = artist;
+        summary->genre = genre;
+        strncpy(summary->album, slot->cd.album, SUMMARY_TEXT_LENGTH - 1);
+        summary->year = slot->cd.year;
+        summary->track_count = slot->cd.track_count;
+        summary->length = slot->cd.track_count > 0 ? length : 0;
+        collection_stats_add(&db->summaries.stats, summary);
+        sort_indexes_insert(&db->summaries.sort, slot_index, db->summaries.summary, db->strings);
+        facet_index_add(&db->facets, slot_index, db->summaries.summary);
+    } else {
+        db->summaries.occupied[slot_index / 32] &= ~bit;
+    }
+    db->summaries_dirty = true;
+    return true;
+}
+
+void flipchanger_db_update_length(FlipChangerDb* db, int32_t slot_index, uint32_t seconds) {
+    if(!db || slot_index < 0 || slot_index >= MAX_SLOTS) {
+        return;
+    }
+
+    // Lists saved before their slot still set it - the slot's summary keeps it
+    SlotSummary* summary = &db->summaries.summary[slot_index];
+    bool occupied = flipchanger_db_is_occupied(db, slot_index);
+    if(occupied) {
+        collection_stats_remove(&db->summaries.stats, summary);
+    }
+    summary->length = seconds > UINT16_MAX ? UINT16_MAX : (uint16_t)seconds;
+    if(occupied) {
+        collection_stats_add(&db->summaries.stats, summary);
+    }
+    db->summaries_dirty = true;
+}
+
+const CollectionStats* flipchanger_db_get_stats(FlipChangerDb* db) {
+    return &db->summaries.stats;
+}
+
+const SortIndexes* flipchanger_db_get_sort(FlipChangerDb* db) {
+    return &db->summaries.sort;
+}
+
+const FacetIndex* flipchanger_db_get_facets(FlipChangerDb* db) {
+    return &db->facets;
+}
+
+const char* flipchanger_db_get_string(FlipChangerDb* db, uint16_t id) {
+    return db ? string_table_get(db->strings, id) : "";
+}
+
+// Helper: Finish or undo a file rewrite cut short by power loss. The new file is
+// complete once the old one is gone; while both exist the new one may be partial
+static void flipchanger_db_recover(FlipChangerDb* db, const char* path, const char* tmp_path) {
+    if(!storage_common_exists(db->storage, tmp_path)) {
+        return;
+    }
+    if(storage_common_exists(db->storage, path)) {
+        storage_common_remove(db->storage, tmp_path);
+    } else {
+        FURI_LOG_W(TAG, "Finishing rewrite of %s", path);
+        storage_common_rename(db->storage, tmp_path, path);
+    }
+}
+
+// Helper: Write the string table - a complete copy is swapped in, so the old table
+// stays readable until the new one is on the card
+static bool flipchanger_db_write_strings(FlipChangerDb* db) {
+    size_t size = string_table_encoded_size(db->strings);
+    uint8_t* data = malloc(size);
+    string_table_encode(db->strings, data);
+
+    File* file = storage_file_alloc(db->storage);
+    bool result =
+        storage_file_open(file, FLIPCHANGER_STRINGS_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+        storage_file_write(file, data, size) == size && storage_file_sync(file);
+    storage_file_close(file);
+    storage_file_free(file);
+    free(data);
+
+    if(!result) {
+        storage_common_remove(db->storage, FLIPCHANGER_STRINGS_TMP_PATH);
+        return false;
+    }
+    storage_common_remove(db->storage, FLIPCHANGER_STRINGS_PATH);
+    if(storage_common_rename(db->storage, FLIPCHANGER_STRINGS_TMP_PATH, FLIPCHANGER_STRINGS_PATH) !=
+       FSE_OK) {
+        return false;
+    }
+    db->strings_dirty = false;
+    return true;
+}
+
+// Helper: Load the string table - false if it is missing or damaged
+static bool flipchanger_db_read_strings(FlipChangerDb* db) {
+    flipchanger_db_recover(db, FLIPCHANGER_STRINGS_PATH, FLIPCHANGER_STRINGS_TMP_PATH);
+
+    File* file = storage_file_alloc(db->storage);
+    bool result = false;
+    if(storage_file_open(file, FLIPCHANGER_STRINGS_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        size_t size = (size_t)storage_file_size(file);
+        uint8_t* data = malloc(size > 0 ? size : 1);
+        result = storage_file_read(file, data, size) == size &&
+                 string_table_decode(db->strings, data, size);
+        free(data);
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    db->strings_dirty = false;
+    return result;
+}
+
+// Helper: Drop names no summary refers to (compaction only - records of journaled slots may
+// still refer to them, but are never read until compaction rewrites them)
+static void flipchanger_db_sweep_strings(FlipChangerDb* db) {
+    uint32_t live[FLIPCHANGER_STRINGS_LIVE_WORDS] = {0};
+    for(int32_t i = 0; i < MAX_SLOTS; i++) {
+        const SlotSummary* summary = &db->summaries.summary[i];
+        if(summary->artist != STRING_ID_NONE && summary->artist <= STRING_TABLE_MAX_ENTRIES) {
+            live[(summary->artist - 1) / 32] |= 1u << ((summary->artist - 1) % 32);
+        }
+        if(summary->genre != STRING_ID_NONE && summary->genre <= STRING_TABLE_MAX_ENTRIES) {
+            live[(summary->genre - 1) / 32] |= 1u << ((summary->genre - 1) % 32);
+        }
+    }
+    uint16_t freed = string_table_sweep(db->strings, live);
+    if(freed > 0) {
+        FURI_LOG_I(TAG, "Dropped %u unused names", (unsigned)freed);
+        db->strings_dirty = true;
+    }
+}
+
+// Helper: Recount the collection totals from the summaries (RAM only) if the stored
+// ones do not match the occupancy bitmap
+static void flipchanger_db_check_stats(FlipChangerDb* db) {
+    if(db->summaries.stats.discs == flipchanger_db_count_occupied(db, MAX_SLOTS)) {
+        return;
+    }
+    FURI_LOG_W(TAG, "Statistics out of step, recounting");
+    collection_stats_reset(&db->summaries.stats);
+    for(int32_t i = 0; i < MAX_SLOTS; i++) {
+        if(flipchanger_db_is_occupied(db, i)) {
+            collection_stats_add(&db->summaries.stats, &db->summaries.summary[i]);
+        }
+    }
+    db->summaries_dirty = true;
+}
+
+// Helper: Rebuild the sort indexes from the summaries (RAM only) unless every occupied
+// slot is in them exactly once
+static void flipchanger_db_check_sort(FlipChangerDb* db) {
+    SortIndexes* sort = &db->summaries.sort;
+    bool valid = sort->count == flipchanger_db_count_occupied(db, MAX_SLOTS);
+    for(int32_t n = 0; n < SORT_INDEXES && valid; n++) {
+        uint32_t seen[FLIPCHANGER_DB_OCCUPIED_WORDS] = {0};
+        for(int32_t i = 0; i < sort->count && valid; i++) {
+            // Range first - a corrupt id must not index seen or the bitmap
+            uint8_t slot = sort->slot[n][i];
+            valid = slot < MAX_SLOTS && flipchanger_db_is_occupied(db, slot) &&
+                    !((seen[slot / 32] >> (slot % 32)) & 1u);
+            if(valid) {
+                seen[slot / 32] |= 1u << (slot % 32);
+            }
+        }
+    }
+    if(valid) {
+        return;
+    }
+    FURI_LOG_W(TAG, "Sort indexes out of step, rebuilding");
+    sort_indexes_reset(sort);
+    for(int32_t i = 0; i < MAX_SLOTS; i++) {
+        if(flipchanger_db_is_occupied(db, i)) {
+            sort_indexes_insert(sort, i, db->summaries.summary, db->strings);
+        }
+    }
+    db->summaries_dirty = true;
+}
+
+// Helper: Build the facet bitsets from the summaries (RAM only)
+static void flipchanger_db_build_facets(FlipChangerDb* db) {
+    facet_index_reset(&db->facets);
+    for(int32_t i = 0; i < MAX_SLOTS; i++) {
+        if(flipchanger_db_is_occupied(db, i)) {
+            facet_index_add(&db->facets, i, db->summaries.summary);
+        }
+    }
+}
+
+// Helper: Write summary section (follows the header)
+static bool flipchanger_db_write_summaries(FlipChangerDb* db) {
+    if(!storage_file_seek(db->file, sizeof(FlipChangerDbHeader), true) ||
+       storage_file_write(db->file, &db->summaries, sizeof(FlipChangerDbSummaries)) !=
+           sizeof(FlipChangerDbSummaries)) {
+        return false;
+    }
+    db->summaries_dirty = false;
+    return true;
+}
+
+// Helper: Write header back to start of file
+static bool flipchanger_db_write_header(FlipChangerDb* db) {
+    if(!storage_file_seek(db->file, 0, true)) {
+        return false;
+    }
+    return storage_file_write(db->file, &db->header, sizeof(FlipChangerDbHeader)) ==
+           sizeof(FlipChangerDbHeader);
+}
+
+// Helper: Append empty records until a file covers record_count records (records start at base)
+static bool flipchanger_db_extend(File* file, uint32_t base, size_t record_size, int32_t record_count) {
+    uint64_t size = storage_file_size(file);
+    if(size >= base + (uint32_t)record_count * record_size) {
+        return true;
+    }
+
+    // Only whole records are appended - a torn tail record is overwritten
+    // (empty records are all zero - readers fill in the slot number)
+    int32_t first = 0;
+    if(size > base) {
+        first = (int32_t)((size - base) / record_size);
+    }
+
+    void* empty = malloc(record_size);
+    memset(empty, 0, record_size);
+    bool result = storage_file_seek(file, base + (uint32_t)first * record_size, true);
+    for(int32_t i = first; result && i < record_count; i++) {
+        result = storage_file_write(file, empty, record_size) == record_size;
+    }
+    free(empty);
+    return result;
+}
+
+// Helper: Append one record to the journal, sets *journal_offset to its payload
+static bool flipchanger_db_journal_append(
+    FlipChangerDb* db,
+    uint32_t magic,
+    int32_t slot_index,
+    const void* data,
+    size_t size,
+    uint32_t* journal_offset) {
+    if(!db->is_open || !db->journal_open) {
+        return false;
+    }
+
+    FlipChangerJournalRecord record = {
+        .magic = magic,
+        .slot_index = (uint16_t)slot_index,
+        .length = (uint16_t)size,
+        .checksum = flipchanger_db_checksum(data, size),
+    };
+
+    if(!storage_file_seek(db->journal, db->journal_size, true) ||
+       storage_file_write(db->journal, &record, sizeof(record)) != sizeof(record) ||
+       storage_file_write(db->journal, data, size) != size || !storage_file_sync(db->journal)) {
+        // Partial record is ignored (and truncated) on next replay
+        return false;
+    }
+
+    *journal_offset = db->journal_size + sizeof(record);
+    db->journal_size += sizeof(record) + size;
+    return true;
+}
+
+// Helper: Byte offset of a slot's search signature
+static uint32_t flipchanger_db_search_offset(int32_t slot_index) {
+    return (uint32_t)slot_index * sizeof(SearchSignature);
+}
+
+// Helper: Log a signature that could not be rewritten - the edit itself is stored, searches
+// may just miss its new text until the database is rebuilt
+static void flipchanger_db_index_check(bool result, int32_t slot_index) {
+    if(!result) {
+        FURI_LOG_W(TAG, "Search index not updated for slot %ld", (long)(slot_index + 1));
+    }
+}
+
+// Helper: Rewrite the artist/album half of a slot's search signature
+static void flipchanger_db_index_slot(FlipChangerDb* db, int32_t slot_index, const Slot* slot) {
+    uint32_t text[SEARCH_TEXT_WORDS] = {0};
+    if(slot->occupied) {
+        search_signature_add(text, SEARCH_TEXT_WORDS, slot->cd.artist);
+        search_signature_add(text, SEARCH_TEXT_WORDS, slot->cd.album);
+    }
+    flipchanger_db_index_check(
+        storage_file_seek(
+            db->search,
+            flipchanger_db_search_offset(slot_index) + offsetof(SearchSignature, text),
+            true) &&
+            storage_file_write(db->search, text, sizeof(text)) == sizeof(text),
+        slot_index);
+}
+
+// Helper: Rewrite the track title half of a slot's search signature
+static void flipchanger_db_index_tracks(
+    FlipChangerDb* db,
+    int32_t slot_index,
+    const TrackList* tracks) {
+    uint32_t bits[SEARCH_TRACKS_WORDS] = {0};
+    for(int32_t i = 0; i < tracks->count; i++) {
+        search_signature_add(bits, SEARCH_TRACKS_WORDS, track_list_title(tracks, i));
+    }
+    flipchanger_db_index_check(
+        storage_file_seek(
+            db->search,
+            flipchanger_db_search_offset(slot_index) + offsetof(SearchSignature, tracks),
+            true) &&
+            storage_file_write(db->search, bits, sizeof(bits)) == sizeof(bits),
+        slot_index);
+}
+
+// Helper: Open journal and replay it into the offset map (truncates a torn tail)
+static bool flipchanger_db_journal_open(FlipChangerDb* db) {
+    memset(db->journal_offset, 0, sizeof(db->journal_offset));
+    memset(db->tracks_journal_offset, 0, sizeof(db->tracks_journal_offset));
+    db->journal_size = 0;
+
+    flipchanger_db_recover(db, FLIPCHANGER_JOURNAL_PATH, FLIPCHANGER_JOURNAL_TMP_PATH);
+    if(!storage_file_open(db->journal, FLIPCHANGER_JOURNAL_PATH, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
+        return false;
+    }
+    db->journal_open = true;
+
+    // Scratch big enough for either payload
+    size_t scratch_size = sizeof(Slot) > TRACK_LIST_MAX_ENCODED_SIZE ? sizeof(Slot) :
+                                                                       TRACK_LIST_MAX_ENCODED_SIZE;
+    void* scratch = malloc(scratch_size);
+    TrackList* tracks = track_list_alloc();
+    uint32_t position = 0;
+    uint32_t replayed = 0;
+    while(true) {
+        FlipChangerJournalRecord record;
+        if(storage_file_read(db->journal, &record, sizeof(record)) != sizeof(record) ||
+           record.slot_index >= MAX_SLOTS) {
+            break;
+        }
+        size_t size = record.length;
+        bool known = (record.magic == FLIPCHANGER_JOURNAL_MAGIC && size == sizeof(Slot)) ||
+                     (record.magic == FLIPCHANGER_JOURNAL_TRACKS_MAGIC &&
+                      size <= TRACK_LIST_MAX_ENCODED_SIZE);
+        if(!known ||
+           storage_file_read(db->journal, scratch, size) != size ||
+           flipchanger_db_checksum(scratch, size) != record.checksum) {
+            break;
+        }
+        if(record.magic == FLIPCHANGER_JOURNAL_MAGIC) {
+            db->journal_offset[record.slot_index] = position + sizeof(record);
+            flipchanger_db_update_summary(db, record.slot_index, scratch);
+            flipchanger_db_index_slot(db, record.slot_index, scratch);
+        } else {
+            db->tracks_journal_offset[record.slot_index] = position + sizeof(record);
+            if(track_list_decode(tracks, scratch, size)) {
+                flipchanger_db_update_length(
+                    db, record.slot_index, track_list_total_duration(tracks));
+                flipchanger_db_index_tracks(db, record.slot_index, tracks);
+            }
+        }
+        position += sizeof(record) + size;
+        replayed++;
+    }
+    track_list_free(tracks);
+    free(scratch);
+
+    // Drop anything after the last good record (power loss mid-append)
+    if(storage_file_size(db->journal) > position) {
+        FURI_LOG_W(TAG, "Journal torn at %lu, truncating", (unsigned long)position);
+        storage_file_seek(db->journal, position, true);
+        storage_file_truncate(db->journal);
+    }
+
+    db->journal_size = position;
+    if(replayed > 0) {
+        FURI_LOG_I(TAG, "Replayed %lu journal records", (unsigned long)replayed);
+    }
+    return true;
+}
+
+// Helper: Empty the journal
+static bool flipchanger_db_journal_reset(FlipChangerDb* db) {
+    if(db->journal_open) {
+        storage_file_close(db->journal);
+        db->journal_open = false;
+    }
+    memset(db->journal_offset, 0, sizeof(db->journal_offset));
+    memset(db->tracks_journal_offset, 0, sizeof(db->tracks_journal_offset));
+    db->journal_size = 0;
+
+    if(!storage_file_open(db->journal, FLIPCHANGER_JOURNAL_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS)) {
+        return false;
+    }
+    db->journal_open = true;
+    return true;
+}
+
+// Helper: Empty the journal except for the newest slot copies of the slots set in keep -
+// they are copied to a fresh journal that is swapped in, so the old one stays readable
+// until the new one is on the card
+static bool flipchanger_db_journal_keep(FlipChangerDb* db, const uint32_t* keep) {
+    bool any = false;
+    for(int32_t w = 0; w < SLOT_BITMAP_WORDS && !any; w++) {
+        any = keep[w] != 0;
+    }
+    if(!any) {
+        return flipchanger_db_journal_reset(db);
+    }
+
+    // Each copy keeps its record header (and checksum) as it is
+    size_t size = sizeof(FlipChangerJournalRecord) + sizeof(Slot);
+    uint8_t* buffer = malloc(size);
+    File* file = storage_file_alloc(db->storage);
+    bool result = storage_file_open(
+        file, FLIPCHANGER_JOURNAL_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    uint32_t position = 0;
+    for(int32_t i = 0; result && i < MAX_SLOTS; i++) {
+        if(!((keep[i / 32] >> (i % 32)) & 1u)) continue;
+        result = storage_file_seek(
+                     db->journal, db->journal_offset[i] - sizeof(FlipChangerJournalRecord), true) &&
+                 storage_file_read(db->journal, buffer, size) == size &&
+                 storage_file_write(file, buffer, size) == size;
+        position += size;
+    }
+    result = result && storage_file_sync(file);
+    storage_file_close(file);
+    storage_file_free(file);
+    free(buffer);
+
+    if(!result) {
+        storage_common_remove(db->storage, FLIPCHANGER_JOURNAL_TMP_PATH);
+        return false;
+    }
+
+    storage_file_close(db->journal);
+    db->journal_open = false;
+    storage_common_remove(db->storage, FLIPCHANGER_JOURNAL_PATH);
+    storage_common_rename(db->storage, FLIPCHANGER_JOURNAL_TMP_PATH, FLIPCHANGER_JOURNAL_PATH);
+
+    // Kept copies sit back to back in slot order
+    position = 0;
+    for(int32_t i = 0; i < MAX_SLOTS; i++) {
+        db->tracks_journal_offset[i] = 0;
+        if((keep[i / 32] >> (i % 32)) & 1u) {
+            db->journal_offset[i] = position + sizeof(FlipChangerJournalRecord);
+            position += size;
+        } else {
+            db->journal_offset[i] = 0;
+        }
+    }
+    db->journal_size = position;
+
+    if(!storage_file_open(db->journal, FLIPCHANGER_JOURNAL_PATH, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_E(TAG, "Failed to reopen journal");
+        memset(db->journal_offset, 0, sizeof(db->journal_offset));
+        db->journal_size = 0;
+        return false;
+    }
+    db->journal_open = true;
+    return true;
+}
+
+// Helper: Byte offset of a tracks directory entry
+static uint32_t flipchanger_db_tracks_entry_offset(int32_t slot_index) {
+    return (uint32_t)slot_index * sizeof(FlipChangerTracksEntry);
+}
+
+// Helper: Read a slot's encoded track list - the newest journaled copy if there is one.
+// *data is malloc'd (NULL with *size 0 when the slot has no tracks)
+static bool flipchanger_db_read_tracks_blob(
+    FlipChangerDb* db,
+    int32_t slot_index,
+    uint8_t** data,
+    uint32_t* size) {
+    *data = NULL;
+    *size = 0;
+
+    File* file = db->tracks;
+    FlipChangerTracksEntry entry = {0};
+    uint32_t journal_offset = db->tracks_journal_offset[slot_index];
+    if(journal_offset && db->journal_open) {
+        // Length is in the record header just before the payload
+        FlipChangerJournalRecord record;
+        if(!storage_file_seek(db->journal, journal_offset - sizeof(record), true) ||
+           storage_file_read(db->journal, &record, sizeof(record)) != sizeof(record)) {
+            return false;
+        }
+        file = db->journal;
+        entry.offset = journal_offset;
+        entry.length = record.length;
+    } else if(
+        !storage_file_seek(db->tracks, flipchanger_db_tracks_entry_offset(slot_index), true) ||
+        storage_file_read(db->tracks, &entry, sizeof(entry)) != sizeof(entry)) {
+        // Past the end of the file it was never written - no tracks. Anything else is a read error
+        return flipchanger_db_tracks_entry_offset(slot_index) + sizeof(entry) >
+               storage_file_size(db->tracks);
+    }
+
+    if(entry.length == 0) {
+        return true;
+    }
+    if(entry.length > TRACK_LIST_MAX_ENCODED_SIZE) {
+        return false;
+    }
+
+    *data = malloc(entry.length);
+    if(!storage_file_seek(file, entry.offset, true) ||
+       storage_file_read(file, *data, entry.length) != entry.length) {
+        free(*data);
+        *data = NULL;
+        return false;
+    }
+    *size = entry.length;
+    return true;
+}
+
+// Helper: Append an encoded track list to the tracks file and point the slot's entry at it.
+// The entry is written last, so a torn append leaves the previous list in place
+static bool flipchanger_db_write_tracks_blob(
+    FlipChangerDb* db,
+    int32_t slot_index,
+    const uint8_t* data,
+    uint32_t size) {
+    FlipChangerTracksEntry entry = {0};
+    if(size > 0) {
+        entry.offset = (uint32_t)storage_file_size(db->tracks);
+        entry.length = size;
+        if(!storage_file_seek(db->tracks, entry.offset, true) ||
+           storage_file_write(db->tracks, data, size) != size) {
+            return false;
+        }
+    }
+    return storage_file_seek(db->tracks, flipchanger_db_tracks_entry_offset(slot_index), true) &&
+           storage_file_write(db->tracks, &entry, sizeof(entry)) == sizeof(entry);
+}
+
+// Helper: Copy the live track lists to a fresh file once superseded ones outweigh them
+static bool flipchanger_db_tracks_vacuum(FlipChangerDb* db) {
+    size_t directory_size = MAX_SLOTS * sizeof(FlipChangerTracksEntry);
+    FlipChangerTracksEntry* directory = malloc(directory_size);
+    if(!storage_file_seek(db->tracks, 0, true) ||
+       storage_file_read(db->tracks, directory, directory_size) != directory_size) {
+        free(directory);
+        return false;
+    }
+
+    uint32_t live = 0;
+    for(int32_t i = 0; i < MAX_SLOTS; i++) {
+        live += directory[i].length;
+    }
+    uint32_t size = (uint32_t)storage_file_size(db->tracks);
+    uint32_t dead = size > directory_size + live ? size - directory_size - live : 0;
+    if(dead < FLIPCHANGER_TRACKS_VACUUM_SIZE || dead < live) {
+        free(directory);
+        return true;
+    }
+
+    // Lists are copied in slot order behind a new directory, then the files are swapped
+    File* file = storage_file_alloc(db->storage);
+    uint8_t* buffer = malloc(TRACK_LIST_MAX_ENCODED_SIZE);
+    bool result = storage_file_open(
+        file, FLIPCHANGER_TRACKS_TMP_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS);
+    uint32_t position = directory_size;
+    for(int32_t i = 0; result && i < MAX_SLOTS; i++) {
+        uint32_t length = directory[i].length;
+        if(length == 0) continue;
+        result = length <= TRACK_LIST_MAX_ENCODED_SIZE &&
+                 storage_file_seek(db->tracks, directory[i].offset, true) &&
+                 storage_file_read(db->tracks, buffer, length) == length &&
+                 storage_file_seek(file, position, true) &&
+                 storage_file_write(file, buffer, length) == length;
+        directory[i].offset = position;
+        position += length;
+    }
+    result = result && storage_file_seek(file, 0, true) &&
+             storage_file_write(file, directory, directory_size) == directory_size &&
+             storage_file_sync(file);
+    storage_file_close(file);
+    storage_file_free(file);
+    free(buffer);
+    free(directory);
+
+    if(!result) {
+        storage_common_remove(db->storage, FLIPCHANGER_TRACKS_TMP_PATH);
+        return false;
+    }
+
+    storage_file_close(db->tracks);
+    storage_common_remove(db->storage, FLIPCHANGER_TRACKS_PATH);
+    storage_common_rename(db->storage, FLIPCHANGER_TRACKS_TMP_PATH, FLIPCHANGER_TRACKS_PATH);
+    if(!storage_file_open(db->tracks, FLIPCHANGER_TRACKS_PATH, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_E(TAG, "Failed to reopen tracks file");
+        db->is_open = false;
+        storage_file_close(db->search);
+        storage_file_close(db->file);
+        return false;
+    }
+    FURI_LOG_I(TAG, "Tracks file rewritten, %lu bytes freed", (unsigned long)dead);
+    return true;
+}
+
+FlipChangerDb* flipchanger_db_alloc(Storage* storage) {
+    FlipChangerDb* db = malloc(sizeof(FlipChangerDb));
+    memset(db, 0, sizeof(FlipChangerDb));
+    db->storage = storage;
+    db->file = storage_file_alloc(storage);
+    db->tracks = storage_file_alloc(storage);
+    db->search = storage_file_alloc(storage);
+    db->journal = storage_file_alloc(storage);
+    db->strings = string_table_alloc();
+    return db;
+}
+
+void flipchanger_db_free(FlipChangerDb* db) {
+    if(!db) return;
+    flipchanger_db_close(db);
+    storage_file_free(db->journal);
+    storage_file_free(db->search);
+    storage_file_free(db->tracks);
+    storage_file_free(db->file);
+    string_table_free(db->strings);
+    free(db);
+}
+
+void flipchanger_db_close(FlipChangerDb* db) {
+    if(db->is_open) {
+        storage_file_close(db->search);
+        storage_file_close(db->tracks);
+        storage_file_close(db->file);
+        db->is_open = false;
+    }
+    if(db->journal_open) {
+        storage_file_close(db->journal);
+        db->journal_open = false;
+    }
+}
+
+bool flipchanger_db_is_open(FlipChangerDb* db) {
+    return db && db->is_open;
+}
+
+bool flipchanger_db_open(FlipChangerDb* db, const FlipChangerDbStamp* source) {
+    flipchanger_db_close(db);
+
+    if(!storage_file_open(db->file, FLIPCHANGER_DB_PATH, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
+        return false;
+    }
+
+    bool valid =
+        storage_file_read(db->file, &db->header, sizeof(FlipChangerDbHeader)) ==
+            sizeof(FlipChangerDbHeader) &&
+        db->header.magic == FLIPCHANGER_DB_MAGIC && db->header.version == FLIPCHANGER_DB_VERSION &&
+        db->header.record_size == sizeof(FlipChangerDbRecord) &&
+        db->header.summary_size == sizeof(SlotSummary) &&
+        db->header.tracks_size == sizeof(FlipChangerTracksEntry) &&
+        db->header.stats_size == sizeof(CollectionStats) &&
+        db->header.search_size == sizeof(SearchSignature) &&
+        db->header.sort_size == sizeof(SortIndexes) &&
+        db->header.total_slots >= MIN_SLOTS &&
+        db->header.total_slots <= MAX_SLOTS &&
+        storage_file_read(db->file, &db->summaries, sizeof(FlipChangerDbSummaries)) ==
+            sizeof(FlipChangerDbSummaries);
+
+    // JSON edited outside the app - database is stale
+    if(valid && source &&
+       (db->header.source_size != source->size || db->header.source_mtime != source->mtime)) {
+        FURI_LOG_I(TAG, "Source changed, rebuilding");
+        valid = false;
+    }
+
+    // Tracks file is part of the database - without it the whole thing is rebuilt
+    if(valid) {
+        flipchanger_db_recover(db, FLIPCHANGER_TRACKS_PATH, FLIPCHANGER_TRACKS_TMP_PATH);
+    }
+    if(valid && !storage_file_open(
+                    db->tracks, FLIPCHANGER_TRACKS_PATH, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_W(TAG, "Tracks file missing, rebuilding");
+        valid = false;
+    }
+
+    // So is the string table the summaries and records refer to
+    if(valid && !flipchanger_db_read_strings(db)) {
+        FURI_LOG_W(TAG, "String table missing, rebuilding");
+        storage_file_close(db->tracks);
+        valid = false;
+    }
+
+    // And the search signatures
+    if(valid &&
+       (!storage_file_open(db->search, FLIPCHANGER_SEARCH_PATH, FSAM_READ_WRITE, FSOM_OPEN_EXISTING) ||
+        storage_file_size(db->search) != MAX_SLOTS * sizeof(SearchSignature))) {
+        FURI_LOG_W(TAG, "Search index missing, rebuilding");
+        storage_file_close(db->search);
+        storage_file_close(db->tracks);
+        valid = false;
+    }
+
+    if(!valid) {
+        storage_file_close(db->file);
+        return false;
+    }
+
+    // Never trust on-disk strings
+    for(int32_t i = 0; i < MAX_SLOTS; i++) {
+        db->summaries.summary[i].album[SUMMARY_TEXT_LENGTH - 1] = '\0';
+    }
+    db->summaries_dirty = false;
+    flipchanger_db_check_stats(db);
+    flipchanger_db_check_sort(db);
+    flipchanger_db_build_facets(db);
+    db->is_open = true;
+
+    // Edits saved since the last compaction (their summaries are applied too)
+    if(!flipchanger_db_journal_open(db)) {
+        FURI_LOG_E(TAG, "Failed to open journal");
+    }
+    return true;
+}
+
+bool flipchanger_db_create(FlipChangerDb* db, int32_t total_slots) {
+    flipchanger_db_close(db);
+    memset(&db->summaries, 0, sizeof(FlipChangerDbSummaries));
+    facet_index_reset(&db->facets);
+    string_table_reset(db->strings);
+
+    storage_common_mkdir(db->storage, "/ext/apps/Tools");
+    if(!storage_file_open(db->file, FLIPCHANGER_DB_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_E(TAG, "Failed to create database");
+        return false;
+    }
+    if(!storage_file_open(db->tracks, FLIPCHANGER_TRACKS_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_E(TAG, "Failed to create tracks file");
+        storage_file_close(db->file);
+        return false;
+    }
+    if(!storage_file_open(db->search, FLIPCHANGER_SEARCH_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_E(TAG, "Failed to create search index");
+        storage_file_close(db->tracks);
+        storage_file_close(db->file);
+        return false;
+    }
+
+    memset(&db->header, 0, sizeof(FlipChangerDbHeader));
+    db->header.magic = FLIPCHANGER_DB_MAGIC;
+    db->header.version = FLIPCHANGER_DB_VERSION;
+    db->header.record_size = sizeof(FlipChangerDbRecord);
+    db->header.total_slots = (uint16_t)total_slots;
+    db->header.summary_size = sizeof(SlotSummary);
+    db->header.tracks_size = sizeof(FlipChangerTracksEntry);
+    db->header.stats_size = sizeof(CollectionStats);
+    db->header.search_size = sizeof(SearchSignature);
+    db->header.sort_size = sizeof(SortIndexes);
+
+    // Empty tracks directory - lists are appended after it. Empty signatures match nothing
+    if(!flipchanger_db_write_header(db) || !flipchanger_db_write_summaries(db) ||
+       !flipchanger_db_write_strings(db) ||
+       !flipchanger_db_extend(db->tracks, 0, sizeof(FlipChangerTracksEntry), MAX_SLOTS) ||
+       !flipchanger_db_extend(db->search, 0, sizeof(SearchSignature), MAX_SLOTS)) {
+        storage_file_close(db->search);
+        storage_file_close(db->tracks);
+        storage_file_close(db->file);
+        return false;
+    }
+
+    db->is_open = true;
+
+    // Journal belonged to the old database
+    flipchanger_db_journal_reset(db);
+    return true;
+}
+
+int32_t flipchanger_db_get_total_slots(FlipChangerDb* db) {
+    return db->header.total_slots;
+}
+
+bool flipchanger_db_set_total_slots(FlipChangerDb* db, int32_t total_slots) {
+    if(!db->is_open || total_slots < MIN_SLOTS || total_slots > MAX_SLOTS) {
+        return false;
+    }
+    db->header.total_slots = (uint16_t)total_slots;
+    return flipchanger_db_write_header(db) &&
+           flipchanger_db_extend(
+               db->file, flipchanger_db_record_offset(0), sizeof(FlipChangerDbRecord), total_slots);
+}
+
+bool flipchanger_db_set_source(FlipChangerDb* db, const FlipChangerDbStamp* source) {
+    if(!db->is_open) {
+        return false;
+    }
+    db->header.source_size = source ? source->size : 0;
+    db->header.source_mtime = source ? source->mtime : 0;
+    return flipchanger_db_write_header(db);
+}
+
+const SlotSummary* flipchanger_db_get_summary(FlipChangerDb* db, int32_t slot_index) {
+    if(!db || slot_index < 0 || slot_index >= MAX_SLOTS) {
+        return NULL;
+    }
+    return &db->summaries.summary[slot_index];
+}
+
+const SlotSummary* flipchanger_db_get_summaries(FlipChangerDb* db) {
+    return db ? db->summaries.summary : NULL;
+}
+
+bool flipchanger_db_is_occupied(FlipChangerDb* db, int32_t slot_index) {
+    if(!db || slot_index < 0 || slot_index >= MAX_SLOTS) {
+        return false;
+    }
+    return (db->summaries.occupied[slot_index / 32] >> (slot_index % 32)) & 1u;
+}
+
+int32_t flipchanger_db_count_occupied(FlipChangerDb* db, int32_t total_slots) {
+    if(!db) {
+        return 0;
+    }
+    if(total_slots > MAX_SLOTS) {
+        total_slots = MAX_SLOTS;
+    }
+
+    // Whole words first, then the bits of the last partial word
+    int32_t count = 0;
+    int32_t i = 0;
+    for(; i + 32 <= total_slots; i += 32) {
+        count += __builtin_popcount(db->summaries.occupied[i / 32]);
+    }
+    if(i < total_slots) {
+        uint32_t mask = (1u << (total_slots - i)) - 1;
+        count += __builtin_popcount(db->summaries.occupied[i / 32] & mask);
+    }
+    return count;
+}
+
+bool flipchanger_db_flush(FlipChangerDb* db) {
+    if(!db->is_open) {
+        return false;
+    }
+    // Names first - the summaries refer to them
+    return (!db->strings_dirty || flipchanger_db_write_strings(db)) &&
+           (!db->summaries_dirty || flipchanger_db_write_summaries(db));
+}
+
+bool flipchanger_db_read_slot(FlipChangerDb* db, int32_t slot_index, Slot* slot) {
+    memset(slot, 0, sizeof(Slot));
+    slot->slot_number = slot_index + 1;
+
+    if(!db->is_open || slot_index < 0 || slot_index >= MAX_SLOTS) {
+        return false;
+    }
+
+    // Newest copy may still be in the journal (as a whole slot)
+    uint32_t journal_offset = db->journal_offset[slot_index];
+    if(journal_offset && db->journal_open) {
+        if(!storage_file_seek(db->journal, journal_offset, true) ||
+           storage_file_read(db->journal, slot, sizeof(Slot)) != sizeof(Slot)) {
+            memset(slot, 0, sizeof(Slot));
+            slot->slot_number = slot_index + 1;
+            return false;
+        }
+    } else {
+        // Records past the end of the file were never written and read as empty - unless the
+        // slot is occupied, which makes it a read error (never pass it off as an empty slot)
+        FlipChangerDbRecord record;
+        if(!storage_file_seek(db->file, flipchanger_db_record_offset(slot_index), true) ||
+           storage_file_read(db->file, &record, sizeof(record)) != sizeof(record)) {
+            if(flipchanger_db_is_occupied(db, slot_index)) {
+                return false;
+            }
+            memset(&record, 0, sizeof(record));
+        }
+        flipchanger_db_record_to_slot(db, &record, slot_index, slot);
+    }
+
+    // Never trust on-disk strings/counts
+    slot->slot_number = slot_index + 1;
+    slot->cd.artist[MAX_ARTIST_LENGTH - 1] = '\0';
+    slot->cd.album[MAX_ALBUM_LENGTH - 1] = '\0';
+    slot->cd.genre[MAX_GENRE_LENGTH - 1] = '\0';
+    slot->cd.notes[MAX_NOTES_LENGTH - 1] = '\0';
+    if(slot->cd.track_count > MAX_TRACKS) slot->cd.track_count = MAX_TRACKS;
+    return true;
+}
+
+bool flipchanger_db_read_tracks(FlipChangerDb* db, int32_t slot_index, TrackList* tracks) {
+    track_list_reset(tracks);
+
+    if(!db->is_open || slot_index < 0 || slot_index >= MAX_SLOTS) {
+        return false;
+    }
+
+    uint8_t* data;
+    uint32_t size;
+    if(!flipchanger_db_read_tracks_blob(db, slot_index, &data, &size)) {
+        return false;
+    }
+
+    // Decode checks every on-disk length
+    bool result = track_list_decode(tracks, data, size);
+    free(data);
+    return result;
+}
+
+bool flipchanger_db_write_slot(FlipChangerDb* db, int32_t slot_index, const Slot* slot) {
+    if(!db->is_open || slot_index < 0 || slot_index >= MAX_SLOTS) {
+        return false;
+    }
+
+    // Fill any gap before this record so every offset stays a valid record
+    if(!flipchanger_db_extend(
+           db->file, flipchanger_db_record_offset(0), sizeof(FlipChangerDbRecord), slot_index)) {
+        return false;
+    }
+
+    FlipChangerDbRecord record;
+    flipchanger_db_slot_to_record(db, slot, &record);
+    if(!storage_file_seek(db->file, flipchanger_db_record_offset(slot_index), true) ||
+       storage_file_write(db->file, &record, sizeof(record)) != sizeof(record)) {
+        return false;
+    }
+    flipchanger_db_index_slot(db, slot_index, slot);
+    return true;
+}
+
+bool flipchanger_db_write_tracks(FlipChangerDb* db, int32_t slot_index, const TrackList* tracks) {
+    if(!db->is_open || slot_index < 0 || slot_index >= MAX_SLOTS) {
+        return false;
+    }
+
+    uint8_t* data = malloc(track_list_encoded_size(tracks));
+    uint32_t size = tracks->count > 0 ? track_list_encode(tracks, data) : 0;
+    bool result = flipchanger_db_write_tracks_blob(db, slot_index, data, size);
+    free(data);
+    if(result) {
+        flipchanger_db_index_tracks(db, slot_index, tracks);
+    }
+    return result;
+}
+
+bool flipchanger_db_journal_slot(FlipChangerDb* db, int32_t slot_index, const Slot* slot) {
+    if(slot_index < 0 || slot_index >= MAX_SLOTS) {
+        return false;
+    }
+    if(!flipchanger_db_journal_append(
+           db,
+           FLIPCHANGER_JOURNAL_MAGIC,
+           slot_index,
+           slot,
+           sizeof(Slot),
+           &db->journal_offset[slot_index])) {
+        return false;
+    }
+    flipchanger_db_index_slot(db, slot_index, slot);
+    return true;
+}
+
+bool flipchanger_db_journal_tracks(FlipChangerDb* db, int32_t slot_index, const TrackList* tracks) {
+    if(slot_index < 0 || slot_index >= MAX_SLOTS) {
+        return false;
+    }
+
+    uint8_t* data = malloc(track_list_encoded_size(tracks));
+    size_t size = track_list_encode(tracks, data);
+    bool result = flipchanger_db_journal_append(
+        db,
+        FLIPCHANGER_JOURNAL_TRACKS_MAGIC,
+        slot_index,
+        data,
+        size,
+        &db->tracks_journal_offset[slot_index]);
+    free(data);
+    if(result) {
+        flipchanger_db_index_tracks(db, slot_index, tracks);
+    }
+    return result;
+}
+
+bool flipchanger_db_search(
+    FlipChangerDb* db,
+    const char* query,
+    uint32_t* text,
+    uint32_t* tracks) {
+    memset(text, 0, SLOT_BITMAP_WORDS * sizeof(uint32_t));
+    memset(tracks, 0, SLOT_BITMAP_WORDS * sizeof(uint32_t));
+    if(!db->is_open) {
+        return false;
+    }
+
+    uint32_t query_text[SEARCH_TEXT_WORDS] = {0};
+    uint32_t query_tracks[SEARCH_TRACKS_WORDS] = {0};
+    search_signature_add(query_text, SEARCH_TEXT_WORDS, query);
+    search_signature_add(query_tracks, SEARCH_TRACKS_WORDS, query);
+
+    // One pass over the file, a few signatures at a time (empty slots are skipped after reading)
+    SearchSignature* chunk = malloc(FLIPCHANGER_SEARCH_CHUNK * sizeof(SearchSignature));
+    bool result = storage_file_seek(db->search, 0, true);
+    for(int32_t first = 0; result && first < MAX_SLOTS; first += FLIPCHANGER_SEARCH_CHUNK) {
+        int32_t count = MAX_SLOTS - first;
+        if(count > FLIPCHANGER_SEARCH_CHUNK) count = FLIPCHANGER_SEARCH_CHUNK;
+        size_t size = count * sizeof(SearchSignature);
+        result = storage_file_read(db->search, chunk, size) == size;
+        for(int32_t i = 0; result && i < count; i++) {
+            int32_t slot_index = first + i;
+            if(!flipchanger_db_is_occupied(db, slot_index)) {
+                continue;
+            }
+            uint32_t bit = 1u << (slot_index % 32);
+            if(search_signature_test(chunk[i].text, query_text, SEARCH_TEXT_WORDS)) {
+                text[slot_index / 32] |= bit;
+            }
+            if(search_signature_test(chunk[i].tracks, query_tracks, SEARCH_TRACKS_WORDS)) {
+                tracks[slot_index / 32] |= bit;
+            }
+        }
+    }
+    free(chunk);
+    return result;
+}
+
+uint32_t flipchanger_db_journal_size(FlipChangerDb* db) {
+    return db ? db->journal_size : 0;
+}
+
+bool flipchanger_db_needs_compact(FlipChangerDb* db) {
+    return db && (db->journal_size > FLIPCHANGER_JOURNAL_COMPACT_SIZE ||
+                  (db->journal_size > 0 &&
+                   string_table_free_ids(db->strings) < FLIPCHANGER_STRINGS_SPARE));
+}
+
+bool flipchanger_db_compact(FlipChangerDb* db) {
+    if(!db->is_open || !db->journal_open) {
+        return false;
+    }
+    if(db->journal_size == 0) {
+        return true;
+    }
+
+    // Names only superseded copies used can go first - a journaled slot's record is never
+    // read while its journal copy exists, and the ids freed here let a save that found the
+    // table full go through when it is retried
+    flipchanger_db_sweep_strings(db);
+
+    // Names the journaled slots use must be on the card before records refer to them
+    if(!flipchanger_db_flush(db)) {
+        FURI_LOG_E(TAG, "Compaction failed, journal kept");
+        return false;
+    }
+
+    // Copy newest journaled version of each slot and track list into its record. A slot
+    // whose names never made it into the table stays journaled (its record would lose them)
+    // and the rest are folded around it
+    Slot* scratch = malloc(sizeof(Slot));
+    uint32_t keep[SLOT_BITMAP_WORDS] = {0};
+    bool result = true;
+    uint32_t folded = 0;
+    for(int32_t i = 0; i < MAX_SLOTS && result; i++) {
+        if(db->journal_offset[i]) {
+            result = flipchanger_db_read_slot(db, i, scratch);
+            if(result && !flipchanger_db_names_interned(db, scratch)) {
+                FURI_LOG_W(TAG, "Names of slot %ld not in table, kept journaled", (long)(i + 1));
+                keep[i / 32] |= 1u << (i % 32);
+            } else if(result) {
+                result = flipchanger_db_write_slot(db, i, scratch);
+                folded++;
+            }
+        }
+        if(result && db->tracks_journal_offset[i]) {
+            // Encoded lists are copied as they are
+            uint8_t* data;
+            uint32_t size;
+            result = flipchanger_db_read_tracks_blob(db, i, &data, &size) &&
+                     flipchanger_db_write_tracks_blob(db, i, data, size);
+            free(data);
+            folded++;
+        }
+    }
+    free(scratch);
+
+    // Records (and their summaries) must be on the card before the journal goes away
+    if(!result || !flipchanger_db_flush(db) || !storage_file_sync(db->file) ||
+       !storage_file_sync(db->tracks)) {
+        FURI_LOG_E(TAG, "Compaction failed, journal kept");
+        return false;
+    }
+
+    FURI_LOG_I(TAG, "Compacted %lu records", (unsigned long)folded);
+    if(!flipchanger_db_journal_keep(db, keep)) {
+        return false;
+    }
+
+    // Every record now matches its summary
+    if(!flipchanger_db_flush(db)) {
+        FURI_LOG_W(TAG, "String table rewrite failed");
+    }
+
+    // No list is journaled any more, so every one is reached through the directory - safe
+    // to move them
+    if(!flipchanger_db_tracks_vacuum(db)) {
+        FURI_LOG_W(TAG, "Tracks file rewrite failed");
+    }
+    return db->is_open;
+}
+
+bool flipchanger_db_stat_source(Storage* storage, const char* path, FlipChangerDbStamp* stamp) {
+    FileInfo info;
+    if(storage_common_stat(storage, path, &info) != FSE_OK) {
+        return false;
+    }
+    stamp->size = (uint32_t)info.size;
+    stamp->mtime = 0;
+    storage_common_timestamp(storage, path, &stamp->mtime);
+    return true;
+}
@@ -0,0 +1,126 @@
+/**
+ * FlipChanger - Binary Slot Database
+ *
+ * Fixed-stride slot records on SD card: a small header and the summary
+ * section, followed by one record per slot, so slot N is always one
+ * seek + one read/write away. Summaries, the occupancy bitmap, the
+ * collection totals, the sort indexes and the facet bitsets for all slots
+ * stay in RAM while the database is open.
+ * The JSON file remains the import/export format; the database is
+ * rebuilt from it whenever the JSON changes outside the app.
+ */
+
+#pragma once
+
+#include "flipchanger.h"
+#include "flipchanger_strings.h"
+#include "flipchanger_stats.h"
+#include "flipchanger_sort.h"
+#include "flipchanger_facets.h"
+#include "flipchanger_search.h"
+
+// Database file (lives next to FLIPCHANGER_DATA_PATH)
+#define FLIPCHANGER_DB_PATH "/ext/apps/Tools/flipchanger_data.db"
+
+// Track lists, one variable-length list per slot (part of the database)
+#define FLIPCHANGER_TRACKS_PATH "/ext/apps/Tools/flipchanger_data.trk"
+#define FLIPCHANGER_TRACKS_TMP_PATH "/ext/apps/Tools/flipchanger_data.trk.tmp"  // Rewrite in progress
+
+// Interned artist/genre names the records refer to (part of the database)
+#define FLIPCHANGER_STRINGS_PATH "/ext/apps/Tools/flipchanger_data.str"
+#define FLIPCHANGER_STRINGS_TMP_PATH "/ext/apps/Tools/flipchanger_data.str.tmp"  // Rewrite in progress
+
+// Search signatures, one fixed-size record per slot (part of the database)
+#define FLIPCHANGER_SEARCH_PATH "/ext/apps/Tools/flipchanger_data.fts"
+
+// Journal of slot edits not yet folded into the database
+#define FLIPCHANGER_JOURNAL_PATH "/ext/apps/Tools/flipchanger_data.jnl"
+#define FLIPCHANGER_JOURNAL_TMP_PATH "/ext/apps/Tools/flipchanger_data.jnl.tmp"  // Rewrite in progress
+#define FLIPCHANGER_JOURNAL_COMPACT_SIZE (32 * 1024)  // Compact once the journal passes this
+
+// Identifies the source JSON file the database was built from
+typedef struct {
+    uint32_t size;
+    uint32_t mtime;
+} FlipChangerDbStamp;
+
+// Allocation
+FlipChangerDb* flipchanger_db_alloc(Storage* storage);
+void flipchanger_db_free(FlipChangerDb* db);
+
+// Open existing database and replay its journal - fails if missing, invalid,
+// or built from a different source
+bool flipchanger_db_open(FlipChangerDb* db, const FlipChangerDbStamp* source);
+
+// Create empty database (replaces any existing file, discards the journal)
+bool flipchanger_db_create(FlipChangerDb* db, int32_t total_slots);
+
+// Close file (db can be opened/created again)
+void flipchanger_db_close(FlipChangerDb* db);
+bool flipchanger_db_is_open(FlipChangerDb* db);
+
+// Header access
+int32_t flipchanger_db_get_total_slots(FlipChangerDb* db);
+bool flipchanger_db_set_total_slots(FlipChangerDb* db, int32_t total_slots);
+bool flipchanger_db_set_source(FlipChangerDb* db, const FlipChangerDbStamp* source);
+
+// Summary access (resident - no SD access; NULL if slot_index is out of range)
+const SlotSummary* flipchanger_db_get_summary(FlipChangerDb* db, int32_t slot_index);
+const SlotSummary* flipchanger_db_get_summaries(FlipChangerDb* db);  // All MAX_SLOTS of them
+bool flipchanger_db_is_occupied(FlipChangerDb* db, int32_t slot_index);
+int32_t flipchanger_db_count_occupied(FlipChangerDb* db, int32_t total_slots);
+
+// Refresh one slot's summary and occupancy bit (RAM only - works without a file, so the
+// list still has summaries when slots are read from the JSON). Record writes leave
+// summaries alone; callers update them once the slot is safely stored. False (and the
+// summary left as it was) if a name does not fit in the string table
+bool flipchanger_db_update_summary(FlipChangerDb* db, int32_t slot_index, const Slot* slot);
+
+// Refresh one slot's playing time from its track list (RAM only, like the summary)
+void flipchanger_db_update_length(FlipChangerDb* db, int32_t slot_index, uint32_t seconds);
+
+// Collection totals (resident - kept in step with the summaries, stored with them)
+const CollectionStats* flipchanger_db_get_stats(FlipChangerDb* db);
+
+// Browse orders (resident - kept in step with the summaries, stored with them)
+const SortIndexes* flipchanger_db_get_sort(FlipChangerDb* db);
+
+// Filter bitsets (resident - kept in step with the summaries, rebuilt from them on open)
+const FacetIndex* flipchanger_db_get_facets(FlipChangerDb* db);
+
+// Name behind a summary's artist/genre id ("" for none) - valid until the next summary update
+const char* flipchanger_db_get_string(FlipChangerDb* db, uint16_t id);
+
+// Write summary section back to the card (after bulk writes)
+bool flipchanger_db_flush(FlipChangerDb* db);
+
+// Record access (slots past the end of file read as empty, journaled copies win)
+bool flipchanger_db_read_slot(FlipChangerDb* db, int32_t slot_index, Slot* slot);
+bool flipchanger_db_read_tracks(FlipChangerDb* db, int32_t slot_index, TrackList* tracks);
+
+// Overwrite record in place (bulk import only - bypasses the journal)
+bool flipchanger_db_write_slot(FlipChangerDb* db, int32_t slot_index, const Slot* slot);
+bool flipchanger_db_write_tracks(FlipChangerDb* db, int32_t slot_index, const TrackList* tracks);
+
+// Search signatures follow every record write and journal append below - nothing to call
+
+// Slots that may contain query (one bit per slot in SLOT_BITMAP_WORDS words): text in their
+// artist/album, tracks in a track title. Reads every signature, no records - false on a read error
+bool flipchanger_db_search(
+    FlipChangerDb* db,
+    const char* query,
+    uint32_t* text,
+    uint32_t* tracks);
+
+// Append edit to the journal (single append, size of collection does not matter)
+bool flipchanger_db_journal_slot(FlipChangerDb* db, int32_t slot_index, const Slot* slot);
+bool flipchanger_db_journal_tracks(FlipChangerDb* db, int32_t slot_index, const TrackList* tracks);
+
+// Journal size in bytes, and fold it back into the database (due once the journal is
+// large or the string table is running out of ids)
+uint32_t flipchanger_db_journal_size(FlipChangerDb* db);
+bool flipchanger_db_needs_compact(FlipChangerDb* db);
+bool flipchanger_db_compact(FlipChangerDb* db);
+
+// Stat source file - returns false if it does not exist
+bool flipchanger_db_stat_source(Storage* storage, const char* path, FlipChangerDbStamp* stamp);
@@ -0,0 +1,105 @@
+/**
+ * FlipChanger - Facet Bitsets
+ */
+
+#include "flipchanger_facets.h"
+#include "flipchanger_strings.h"  // STRING_ID_NONE
+#include <string.h>
+
+// Helper: Bitset of a genre, -1 if it has none
+static int32_t facet_index_find_genre(const FacetIndex* index, uint16_t genre) {
+    for(int32_t i = 0; i < FACET_GENRES; i++) {
+        if(index->genre_id[i] == genre) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void facet_index_reset(FacetIndex* index) {
+    memset(index, 0, sizeof(FacetIndex));
+}
+
+int32_t facet_decade(uint16_t year) {
+    int32_t decade = collection_stats_decade(year);
+    return decade >= 0 ? decade : FACET_NO_YEAR;
+}
+
+void facet_index_add(FacetIndex* index, int32_t slot_index, const SlotSummary* summaries) {
+    const SlotSummary* summary = &summaries[slot_index];
+    uint32_t bit = 1u << (slot_index % 32);
+    index->decade[facet_decade(summary->year)][slot_index / 32] |= bit;
+    
+    uint16_t genre = summary->genre;
+    if(genre == STRING_ID_NONE) {
+        return;
+    }
+    int32_t entry = facet_index_find_genre(index, genre);
+    if(entry < 0) {
+        // New to the bitsets - its other slots (if any) came in while it had none
+        entry = facet_index_find_genre(index, STRING_ID_NONE);
+        if(entry < 0) {
+            return;
+        }
+        index->genre_id[entry] = genre;
+        memset(index->genre[entry], 0, sizeof(index->genre[entry]));
+        for(int32_t i = 0; i < MAX_SLOTS; i++) {
+            if(summaries[i].genre == genre) {
+                index->genre[entry][i / 32] |= 1u << (i % 32);
+            }
+        }
+    }
+    index->genre[entry][slot_index / 32] |= bit;
+}
+
+void facet_index_remove(FacetIndex* index, int32_t slot_index, const SlotSummary* summary) {
+    uint32_t bit = 1u << (slot_index % 32);
+    index->decade[facet_decade(summary->year)][slot_index / 32] &= ~bit;
+    
+    int32_t entry = summary->genre != STRING_ID_NONE ? facet_index_find_genre(index, summary->genre) : -1;
+    if(entry < 0) {
+        return;
+    }
+    index->genre[entry][slot_index / 32] &= ~bit;
+    
+    // Last disc of the genre gone - the bitset goes back
+    for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+        if(index->genre[entry][w]) {
+            return;
+        }
+    }
+    index->genre_id[entry] = STRING_ID_NONE;
+}
+
+void facet_index_or_decade(const FacetIndex* index, int32_t decade, uint32_t* bits) {
+    if(decade < 0 || decade >= FACET_DECADES) {
+        return;
+    }
+    for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+        bits[w] |= index->decade[decade][w];
+    }
+}
+
+void facet_index_or_genre(
+    const FacetIndex* index,
+    uint16_t genre,
+    const SlotSummary* summaries,
+    uint32_t* bits) {
+    if(genre == STRING_ID_NONE) {
+        return;
+    }
+    int32_t entry = facet_index_find_genre(index, genre);
+    if(entry >= 0) {
+        for(int32_t w = 0; w < SLOT_BITMAP_WORDS; w++) {
+            bits[w] |= index->genre[entry][w];
+        }
+        return;
+    }
+    
+    // One of the genres past FACET_GENRES
+    for(int32_t i = 0; i < MAX_SLOTS; i++) {
+        if(summaries[i].genre == genre) {
+            bits[i / 32] |= 1u << (i % 32);
+        }
+    }
+}
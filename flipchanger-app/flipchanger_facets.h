@@ -0,0 +1,51 @@
+/**
+ * FlipChanger - Facet Bitsets
+ *
+ * One bit per slot for every facet value the slot list can be filtered by:
+ * each decade (plus "no year") and each genre. A filter is a few word-wide
+ * ANDs and ORs of these, so it never looks at a slot, a summary or the card.
+ *
+ * Genre ids come from the string table, which has far more ids than a
+ * collection has genres, so bitsets are handed out to genres as they appear
+ * (filled from the summaries) and taken back when their last disc goes.
+ * Past FACET_GENRES genres the rest have none and are looked up in the
+ * summaries instead.
+ *
+ * Summaries of empty slots are all zero, so a genre id in a summary always
+ * belongs to an occupied slot. The bitsets live in RAM only - they are
+ * rebuilt from the summaries on open.
+ */
+
+#pragma once
+
+#include "flipchanger.h"
+#include "flipchanger_stats.h"  // STATS_DECADES
+
+#define FACET_GENRES 32                    // Genres with a bitset of their own
+#define FACET_DECADES (STATS_DECADES + 1)  // Last one: no year (or outside the decades)
+#define FACET_NO_YEAR STATS_DECADES
+
+struct FacetIndex {
+    uint32_t decade[FACET_DECADES][SLOT_BITMAP_WORDS];
+    uint16_t genre_id[FACET_GENRES];  // STRING_ID_NONE = bitset free
+    uint32_t genre[FACET_GENRES][SLOT_BITMAP_WORDS];
+};
+
+// Drop every bit
+void facet_index_reset(FacetIndex* index);
+
+// Count an occupied slot in or out by its summary (summaries = all MAX_SLOTS of them - a
+// genre getting a bitset picks up its other slots from them)
+void facet_index_add(FacetIndex* index, int32_t slot_index, const SlotSummary* summaries);
+void facet_index_remove(FacetIndex* index, int32_t slot_index, const SlotSummary* summary);
+
+// Decade bucket of a year (FACET_NO_YEAR if it has none)
+int32_t facet_decade(uint16_t year);
+
+// OR the slots of a decade/genre into bits (summaries as for facet_index_add)
+void facet_index_or_decade(const FacetIndex* index, int32_t decade, uint32_t* bits);
+void facet_index_or_genre(
+    const FacetIndex* index,
+    uint16_t genre,
+    const SlotSummary* summaries,
+    uint32_t* bits);
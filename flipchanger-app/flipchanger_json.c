@@ -0,0 +1,329 @@
+/**
+ * FlipChanger - JSON Streaming
+ *
+ * Tokenizer reads the stream in JSON_READER_BUFFER_SIZE chunks and
+ * hands out one token at a time - nothing else is ever buffered.
+ * Writer collects output in JSON_WRITER_BUFFER_SIZE chunks, so an export
+ * costs one storage call per sector instead of one per field or character.
+ */
+
+#include "flipchanger_json.h"
+#include <stdio.h>
+#include <string.h>
+
+#define JSON_EOF (-1)
+
+void json_reader_init(JsonReader* reader, Stream* stream) {
+    memset(reader, 0, sizeof(JsonReader));
+    reader->stream = stream;
+    reader->offset = stream_tell(stream);
+}
+
+// Helper: Peek next byte (refills buffer when empty)
+static int json_reader_peek(JsonReader* reader) {
+    if(reader->buffer_pos >= reader->buffer_len) {
+        reader->buffer_len = stream_read(reader->stream, reader->buffer, sizeof(reader->buffer));
+        reader->buffer_pos = 0;
+        if(reader->buffer_len == 0) {
+            return JSON_EOF;
+        }
+    }
+    return reader->buffer[reader->buffer_pos];
+}
+
+// Helper: Consume next byte
+static int json_reader_getc(JsonReader* reader) {
+    int c = json_reader_peek(reader);
+    if(c != JSON_EOF) {
+        reader->buffer_pos++;
+        reader->offset++;
+    }
+    return c;
+}
+
+// Helper: Skip whitespace (and, optionally, value separators)
+static int json_reader_skip_space(JsonReader* reader, bool skip_separators) {
+    int c = json_reader_peek(reader);
+    while(c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+          (skip_separators && (c == ',' || c == ':'))) {
+        json_reader_getc(reader);
+        c = json_reader_peek(reader);
+    }
+    return c;
+}
+
+// Helper: Parse 4 hex digits of a \u escape
+static int32_t json_reader_read_hex4(JsonReader* reader) {
+    int32_t value = 0;
+    for(int32_t i = 0; i < 4; i++) {
+        int c = json_reader_getc(reader);
+        value <<= 4;
+        if(c >= '0' && c <= '9') {
+            value |= c - '0';
+        } else if(c >= 'a' && c <= 'f') {
+            value |= c - 'a' + 10;
+        } else if(c >= 'A' && c <= 'F') {
+            value |= c - 'A' + 10;
+        } else {
+            return -1;
+        }
+    }
+    return value;
+}
+
+// Helper: Read string body (opening quote already consumed)
+static bool json_reader_read_string(JsonReader* reader) {
+    size_t len = 0;
+    reader->truncated = false;
+
+    while(true) {
+        int c = json_reader_getc(reader);
+        if(c == JSON_EOF) {
+            reader->text[len] = '\0';
+            return false;
+        }
+        if(c == '"') {
+            break;
+        }
+        if(c == '\\') {
+            c = json_reader_getc(reader);
+            switch(c) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'u': {
+                    // Only ASCII is representable on screen - map the rest to '?'
+                    int32_t code = json_reader_read_hex4(reader);
+                    c = (code > 0 && code < 0x80) ? (int)code : '?';
+                    break;
+                }
+                case JSON_EOF:
+                    reader->text[len] = '\0';
+                    return false;
+                default:
+                    break;  // '"', '\\', '/' and unknown escapes map to themselves
+            }
+        }
+        if(len < sizeof(reader->text) - 1) {
+            reader->text[len++] = (char)c;
+        } else {
+            reader->truncated = true;
+        }
+    }
+
+    reader->text[len] = '\0';
+    return true;
+}
+
+// Helper: Read integer (fraction/exponent are consumed and dropped)
+static void json_reader_read_number(JsonReader* reader) {
+    bool negative = false;
+    int32_t value = 0;
+
+    if(json_reader_peek(reader) == '-') {
+        negative = true;
+        json_reader_getc(reader);
+    }
+
+    int c = json_reader_peek(reader);
+    while(c >= '0' && c <= '9') {
+        if(value < 100000000) {
+            value = value * 10 + (c - '0');
+        }
+        json_reader_getc(reader);
+        c = json_reader_peek(reader);
+    }
+
+    while(c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-' || (c >= '0' && c <= '9')) {
+        json_reader_getc(reader);
+        c = json_reader_peek(reader);
+    }
+
+    reader->number = negative ? -value : value;
+}
+
+// Helper: Read bare word (true/false/null)
+static JsonToken json_reader_read_literal(JsonReader* reader) {
+    char word[6];
+    size_t len = 0;
+    int c = json_reader_peek(reader);
+    while(c >= 'a' && c <= 'z') {
+        if(len < sizeof(word) - 1) {
+            word[len++] = (char)c;
+        }
+        json_reader_getc(reader);
+        c = json_reader_peek(reader);
+    }
+    word[len] = '\0';
+
+    if(strcmp(word, "true") == 0) return JsonTokenTrue;
+    if(strcmp(word, "false") == 0) return JsonTokenFalse;
+    if(strcmp(word, "null") == 0) return JsonTokenNull;
+    return JsonTokenError;
+}
+
+JsonToken json_reader_next(JsonReader* reader) {
+    int c = json_reader_skip_space(reader, true);
+    reader->token_offset = reader->offset;
+
+    switch(c) {
+        case JSON_EOF:
+            return JsonTokenEnd;
+        case '{':
+            json_reader_getc(reader);
+            return JsonTokenObjectStart;
+        case '}':
+            json_reader_getc(reader);
+            return JsonTokenObjectEnd;
+        case '[':
+            json_reader_getc(reader);
+            return JsonTokenArrayStart;
+        case ']':
+            json_reader_getc(reader);
+            return JsonTokenArrayEnd;
+        case '"':
+            json_reader_getc(reader);
+            if(!json_reader_read_string(reader)) {
+                return JsonTokenError;
+            }
+            // A string followed by ':' is an object key
+            if(json_reader_skip_space(reader, false) == ':') {
+                json_reader_getc(reader);
+                return JsonTokenKey;
+            }
+            return JsonTokenString;
+        default:
+            if(c == '-' || (c >= '0' && c <= '9')) {
+                json_reader_read_number(reader);
+                return JsonTokenNumber;
+            }
+            if(c >= 'a' && c <= 'z') {
+                return json_reader_read_literal(reader);
+            }
+            return JsonTokenError;
+    }
+}
+
+bool json_reader_skip_container(JsonReader* reader) {
+    int32_t depth = 1;
+    while(depth > 0) {
+        switch(json_reader_next(reader)) {
+            case JsonTokenObjectStart:
+            case JsonTokenArrayStart:
+                depth++;
+                break;
+            case JsonTokenObjectEnd:
+            case JsonTokenArrayEnd:
+                depth--;
+                break;
+            case JsonTokenError:
+            case JsonTokenEnd:
+                return false;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+bool json_reader_skip_value(JsonReader* reader) {
+    switch(json_reader_next(reader)) {
+        case JsonTokenObjectStart:
+        case JsonTokenArrayStart:
+            return json_reader_skip_container(reader);
+        case JsonTokenString:
+        case JsonTokenNumber:
+        case JsonTokenTrue:
+        case JsonTokenFalse:
+        case JsonTokenNull:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void json_reader_copy_text(JsonReader* reader, char* dest, size_t dest_size) {
+    if(dest_size == 0) return;
+    strncpy(dest, reader->text, dest_size - 1);
+    dest[dest_size - 1] = '\0';
+}
+
+void json_writer_init(JsonWriter* writer, File* file) {
+    memset(writer, 0, sizeof(JsonWriter));
+    writer->file = file;
+    writer->offset = storage_file_tell(file);
+}
+
+bool json_writer_flush(JsonWriter* writer) {
+    if(writer->buffer_len > 0) {
+        size_t written = storage_file_write(writer->file, writer->buffer, writer->buffer_len);
+        writer->write_calls++;
+        writer->bytes += written;
+        if(written != writer->buffer_len) {
+            writer->error = true;
+        }
+        writer->buffer_len = 0;
+    }
+    return !writer->error;
+}
+
+void json_writer_raw(JsonWriter* writer, const char* data, size_t len) {
+    while(len > 0) {
+        if(writer->buffer_len == sizeof(writer->buffer)) {
+            json_writer_flush(writer);
+        }
+        size_t chunk = sizeof(writer->buffer) - writer->buffer_len;
+        if(chunk > len) {
+            chunk = len;
+        }
+        memcpy(writer->buffer + writer->buffer_len, data, chunk);
+        writer->buffer_len += chunk;
+        writer->offset += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+void json_writer_text(JsonWriter* writer, const char* text) {
+    json_writer_raw(writer, text, strlen(text));
+}
+
+void json_writer_string(JsonWriter* writer, const char* str) {
+    json_writer_raw(writer, "\"", 1);
+
+    // Copy runs of plain characters in one go, escape the rest
+    const char* run = str ? str : "";
+    const char* p = run;
+    for(; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if(c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+        json_writer_raw(writer, run, p - run);
+        run = p + 1;
+
+        char escape[8];
+        switch(c) {
+            case '"': json_writer_raw(writer, "\\\"", 2); break;
+            case '\\': json_writer_raw(writer, "\\\\", 2); break;
+            case '\n': json_writer_raw(writer, "\\n", 2); break;
+            case '\t': json_writer_raw(writer, "\\t", 2); break;
+            case '\r': json_writer_raw(writer, "\\r", 2); break;
+            default:
+                snprintf(escape, sizeof(escape), "\\u%04x", c);
+                json_writer_raw(writer, escape, 6);
+                break;
+        }
+    }
+    json_writer_raw(writer, run, p - run);
+
+    json_writer_raw(writer, "\"", 1);
+}
+
+void json_writer_int(JsonWriter* writer, int32_t value) {
+    char number[16];
+    int len = snprintf(number, sizeof(number), "%ld", (long)value);
+    json_writer_raw(writer, number, len);
+}
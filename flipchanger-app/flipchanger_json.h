@@ -0,0 +1,103 @@
+/**
+ * FlipChanger - JSON Streaming
+ *
+ * Pull-style JSON tokenizer on top of a buffered file stream, and a
+ * buffered writer for the export. Memory use is fixed (one small buffer
+ * each), so files of any size can be read or written without loading
+ * them into RAM.
+ */
+
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include <stream/stream.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Bytes pulled from the stream per refill
+#define JSON_READER_BUFFER_SIZE 64
+
+// Longest string token kept (longer strings are truncated, not an error)
+#define JSON_READER_TEXT_SIZE 256
+
+// Bytes collected per storage_file_write (one SD sector)
+#define JSON_WRITER_BUFFER_SIZE 512
+
+// Token types returned by json_reader_next()
+typedef enum {
+    JsonTokenError,
+    JsonTokenEnd,
+    JsonTokenObjectStart,
+    JsonTokenObjectEnd,
+    JsonTokenArrayStart,
+    JsonTokenArrayEnd,
+    JsonTokenKey,       // String followed by ':' (text in reader->text)
+    JsonTokenString,    // String value (text in reader->text)
+    JsonTokenNumber,    // Integer value (in reader->number)
+    JsonTokenTrue,
+    JsonTokenFalse,
+    JsonTokenNull,
+} JsonToken;
+
+typedef struct {
+    Stream* stream;
+
+    // Read-ahead buffer
+    uint8_t buffer[JSON_READER_BUFFER_SIZE];
+    size_t buffer_len;
+    size_t buffer_pos;
+    size_t offset;              // Absolute offset of the next unread byte
+
+    // Last token
+    size_t token_offset;        // Absolute offset where the last token started
+    char text[JSON_READER_TEXT_SIZE];
+    int32_t number;
+    bool truncated;             // Last string did not fit in text[]
+} JsonReader;
+
+// Reader setup (stream must already be open; reader does not own it)
+void json_reader_init(JsonReader* reader, Stream* stream);
+
+// Pull next token (',' and ':' separators are consumed silently)
+JsonToken json_reader_next(JsonReader* reader);
+
+// Skip the value that follows a key (handles nested objects/arrays)
+bool json_reader_skip_value(JsonReader* reader);
+
+// Skip the rest of the container whose start token was just read
+bool json_reader_skip_container(JsonReader* reader);
+
+// Copy last string token into dest (always null-terminated)
+void json_reader_copy_text(JsonReader* reader, char* dest, size_t dest_size);
+
+typedef struct {
+    File* file;
+
+    // Pending output
+    uint8_t buffer[JSON_WRITER_BUFFER_SIZE];
+    size_t buffer_len;
+    size_t offset;              // Absolute offset of the next byte written
+
+    // Cost of the write so far
+    uint32_t write_calls;       // storage_file_write calls made
+    uint32_t bytes;             // Bytes handed to storage
+    bool error;                 // A write came up short (sticky)
+} JsonWriter;
+
+// Writer setup (file must already be open for writing; writer does not own it)
+void json_writer_init(JsonWriter* writer, File* file);
+
+// Append raw bytes / null-terminated text
+void json_writer_raw(JsonWriter* writer, const char* data, size_t len);
+void json_writer_text(JsonWriter* writer, const char* text);
+
+// Append quoted string (quotes, backslashes and control characters escaped)
+void json_writer_string(JsonWriter* writer, const char* str);
+
+// Append integer
+void json_writer_int(JsonWriter* writer, int32_t value);
+
+// Write out whatever is buffered - returns false if any write so far failed
+bool json_writer_flush(JsonWriter* writer);
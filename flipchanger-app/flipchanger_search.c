@@ -0,0 +1,67 @@
+/**
+ * FlipChanger - Search
+ *
+ * A trigram's bit is the FNV-1a hash of its three upper-cased characters,
+ * modulo the signature size in bits.
+ */
+
+#include "flipchanger_search.h"
+#include <string.h>
+
+// Helper: Upper-case ASCII letters (the picker has no lower case)
+static char search_fold(char c) {
+    return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+}
+
+// Helper: Bit of one trigram in a signature of words uint32_t
+static uint32_t search_trigram_bit(const char* text, int32_t words) {
+    uint32_t hash = 2166136261u;
+    for(int32_t i = 0; i < 3; i++) {
+        hash = (hash ^ (uint8_t)search_fold(text[i])) * 16777619u;
+    }
+    return hash % ((uint32_t)words * 32);
+}
+
+void search_signature_add(uint32_t* bits, int32_t words, const char* text) {
+    size_t length = strlen(text);
+    for(size_t i = 0; i + 3 <= length; i++) {
+        uint32_t bit = search_trigram_bit(text + i, words);
+        bits[bit / 32] |= 1u << (bit % 32);
+    }
+}
+
+bool search_signature_test(const uint32_t* bits, const uint32_t* query, int32_t words) {
+    for(int32_t i = 0; i < words; i++) {
+        if((bits[i] & query[i]) != query[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool search_text_matches(const char* text, const char* query) {
+    size_t query_length = strlen(query);
+    for(const char* start = text; *start; start++) {
+        size_t i = 0;
+        while(i < query_length && start[i] && search_fold(start[i]) == search_fold(query[i])) {
+            i++;
+        }
+        if(i == query_length) {
+            return true;
+        }
+    }
+    return query_length == 0;
+}
+
+bool search_results_add(SearchResults* results, int32_t slot_index, int32_t track, const char* text) {
+    if(results->count >= SEARCH_MAX_RESULTS) {
+        results->more = true;
+        return false;
+    }
+    SearchMatch* match = &results->match[results->count++];
+    match->slot_index = (uint8_t)slot_index;
+    match->track = (uint8_t)track;
+    strncpy(match->text, text, SEARCH_RESULT_TEXT_LENGTH - 1);
+    match->text[SEARCH_RESULT_TEXT_LENGTH - 1] = '\0';
+    return true;
+}
@@ -0,0 +1,58 @@
+/**
+ * FlipChanger - Search
+ *
+ * Each slot gets two trigram signatures: one over its artist and album,
+ * one over all of its track titles. Every three-character run of a text
+ * sets one hashed bit, so a slot can only contain a query if its
+ * signature has every bit the query sets. Testing a signature costs a
+ * few word compares; only the slots that pass are read and checked.
+ *
+ * Matching ignores case (queries come from the upper-case picker).
+ */
+
+#pragma once
+
+#include <furi.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SEARCH_TEXT_WORDS 8      // 256-bit signature of artist + album
+#define SEARCH_TRACKS_WORDS 32   // 1024-bit signature of every track title
+#define SEARCH_MIN_QUERY 3       // Shorter queries have no trigram to look up
+#define SEARCH_QUERY_LENGTH 32   // Including terminator
+#define SEARCH_MAX_RESULTS 40
+#define SEARCH_RESULT_TEXT_LENGTH 24  // Matched text kept per result (prefix)
+#define SEARCH_NO_TRACK 0xFF          // Result is an artist/album match
+
+// Signature record of one slot
+typedef struct {
+    uint32_t text[SEARCH_TEXT_WORDS];
+    uint32_t tracks[SEARCH_TRACKS_WORDS];
+} SearchSignature;
+
+// One match - a slot's artist/album, or one of its tracks
+typedef struct {
+    uint8_t slot_index;
+    uint8_t track;  // Track index, SEARCH_NO_TRACK for artist/album
+    char text[SEARCH_RESULT_TEXT_LENGTH];
+} SearchMatch;
+
+typedef struct {
+    int32_t count;
+    bool more;  // Stopped at SEARCH_MAX_RESULTS
+    SearchMatch match[SEARCH_MAX_RESULTS];
+} SearchResults;
+
+// Set the bits of every trigram of text (words = signature size in uint32_t)
+void search_signature_add(uint32_t* bits, int32_t words, const char* text);
+
+// True if bits has every bit of query set
+bool search_signature_test(const uint32_t* bits, const uint32_t* query, int32_t words);
+
+// Case-insensitive substring test
+bool search_text_matches(const char* text, const char* query);
+
+// Add a match - false once the results are full
+bool search_results_add(SearchResults* results, int32_t slot_index, int32_t track, const char* text);
@@ -0,0 +1,135 @@
+/**
+ * FlipChanger - Sort Indexes
+ *
+ * Names compare without case; empty names and unknown years sort after
+ * every real one, so discs with missing fields collect at the end.
+ */
+
+#include "flipchanger_sort.h"
+#include <string.h>
+
+// Helper: Upper-case ASCII letters
+static char sort_fold(char c) {
+    return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+}
+
+// Helper: Compare two names, empty last
+static int32_t sort_compare_text(const char* a, const char* b) {
+    if(!*a || !*b) {
+        return (int32_t)(*a == '\0') - (int32_t)(*b == '\0');
+    }
+    while(*a && sort_fold(*a) == sort_fold(*b)) {
+        a++;
+        b++;
+    }
+    return (int32_t)(uint8_t)sort_fold(*a) - (int32_t)(uint8_t)sort_fold(*b);
+}
+
+// Helper: Compare two years, none (0) last
+static int32_t sort_compare_year(uint16_t a, uint16_t b) {
+    if(a == 0 || b == 0) {
+        return (int32_t)(a == 0) - (int32_t)(b == 0);
+    }
+    return (int32_t)a - (int32_t)b;
+}
+
+// Helper: Order of slots a and b in an index - never 0 for two different slots
+static int32_t sort_compare(
+    SortOrder order,
+    int32_t a,
+    int32_t b,
+    const SlotSummary* summaries,
+    const StringTable* strings) {
+    const SlotSummary* x = &summaries[a];
+    const SlotSummary* y = &summaries[b];
+    const char* x_artist = string_table_get(strings, x->artist);
+    const char* y_artist = string_table_get(strings, y->artist);
+    
+    int32_t result = 0;
+    if(order == SortByYear) {
+        result = sort_compare_year(x->year, y->year);
+    } else if(order == SortByGenre) {
+        result = sort_compare_text(
+            string_table_get(strings, x->genre), string_table_get(strings, y->genre));
+    } else if(order == SortByAlbum) {
+        result = sort_compare_text(x->album, y->album);
+    }
+    if(result == 0) {
+        result = sort_compare_text(x_artist, y_artist);
+    }
+    if(result == 0 && order != SortByAlbum) {
+        result = sort_compare_text(x->album, y->album);
+    }
+    return result != 0 ? result : a - b;
+}
+
+void sort_indexes_reset(SortIndexes* indexes) {
+    memset(indexes, 0, sizeof(SortIndexes));
+}
+
+void sort_indexes_insert(
+    SortIndexes* indexes,
+    int32_t slot_index,
+    const SlotSummary* summaries,
+    const StringTable* strings) {
+    if(indexes->count >= MAX_SLOTS) {
+        return;
+    }
+    for(int32_t n = 0; n < SORT_INDEXES; n++) {
+        uint8_t* slots = indexes->slot[n];
+        
+        // First position that sorts after the slot
+        int32_t low = 0;
+        int32_t high = indexes->count;
+        while(low < high) {
+            int32_t middle = (low + high) / 2;
+            if(sort_compare((SortOrder)(n + 1), slots[middle], slot_index, summaries, strings) < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        memmove(&slots[low + 1], &slots[low], indexes->count - low);
+        slots[low] = (uint8_t)slot_index;
+    }
+    indexes->count++;
+}
+
+void sort_indexes_remove(SortIndexes* indexes, int32_t slot_index) {
+    bool found = false;
+    for(int32_t n = 0; n < SORT_INDEXES; n++) {
+        uint8_t* slots = indexes->slot[n];
+        for(int32_t i = 0; i < indexes->count; i++) {
+            if(slots[i] == slot_index) {
+                memmove(&slots[i], &slots[i + 1], indexes->count - i - 1);
+                found = true;
+                break;
+            }
+        }
+    }
+    if(found) {
+        indexes->count--;
+    }
+}
+
+const uint8_t* sort_indexes_get(const SortIndexes* indexes, SortOrder order) {
+    if(order <= SortBySlot || order >= SortByCount) {
+        return NULL;
+    }
+    return indexes->slot[order - 1];
+}
+
+const char* sort_order_name(SortOrder order) {
+    switch(order) {
+        case SortByArtist:
+            return "Artist";
+        case SortByAlbum:
+            return "Album";
+        case SortByYear:
+            return "Year";
+        case SortByGenre:
+            return "Genre";
+        default:
+            return "Slot";
+    }
+}
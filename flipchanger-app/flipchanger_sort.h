@@ -0,0 +1,42 @@
+/**
+ * FlipChanger - Sort Indexes
+ *
+ * One permutation of the occupied slots per browse order, kept sorted as
+ * summaries change: a save takes the slot out of every order and inserts
+ * it again where a binary search says it belongs. Keys come from the
+ * summaries and the string table only, so sorting never reads a slot.
+ * Ties fall through to the next key and finally the slot number, so each
+ * order is total and a slot has exactly one place in it.
+ *
+ * The orders are stored with the summaries (see flipchanger_db.c).
+ */
+
+#pragma once
+
+#include "flipchanger.h"
+#include "flipchanger_strings.h"
+
+#define SORT_INDEXES (SortByCount - 1)  // Slot order needs no index
+
+struct SortIndexes {
+    uint8_t count;                          // Occupied slots (in every order)
+    uint8_t slot[SORT_INDEXES][MAX_SLOTS];  // Slot indexes of order n + 1 (MAX_SLOTS fits uint8_t)
+};
+
+// Drop every slot
+void sort_indexes_reset(SortIndexes* indexes);
+
+// Put an occupied slot into every order by its summary (summaries = all MAX_SLOTS of them),
+// or take it out again (before its summary changes)
+void sort_indexes_insert(
+    SortIndexes* indexes,
+    int32_t slot_index,
+    const SlotSummary* summaries,
+    const StringTable* strings);
+void sort_indexes_remove(SortIndexes* indexes, int32_t slot_index);
+
+// Slots of an order, count of them in indexes->count (NULL for SortBySlot)
+const uint8_t* sort_indexes_get(const SortIndexes* indexes, SortOrder order);
+
+// Short name of an order ("Slot", "Artist", ...)
+const char* sort_order_name(SortOrder order);
@@ -0,0 +1,92 @@
+/**
+ * FlipChanger - Collection Statistics
+ *
+ * Counts never go below zero - a total that was stored out of step with
+ * the summaries can be off, but never wraps around.
+ */
+
+#include "flipchanger_stats.h"
+#include <string.h>
+
+int32_t collection_stats_decade(uint16_t year) {
+    if(year < STATS_FIRST_YEAR) {
+        return -1;
+    }
+    int32_t decade = (year - STATS_FIRST_YEAR) / 10;
+    return decade < STATS_DECADES ? decade : -1;
+}
+
+// Helper: Bump the count of a string id (STRING_ID_NONE has none)
+static void collection_stats_count(uint8_t* counts, uint16_t id, int32_t delta) {
+    if(id == STRING_ID_NONE || id > STRING_TABLE_MAX_ENTRIES) {
+        return;
+    }
+    uint8_t* count = &counts[id - 1];
+    if(delta > 0 && *count < UINT8_MAX) {
+        (*count)++;
+    } else if(delta < 0 && *count > 0) {
+        (*count)--;
+    }
+}
+
+void collection_stats_reset(CollectionStats* stats) {
+    memset(stats, 0, sizeof(CollectionStats));
+}
+
+void collection_stats_add(CollectionStats* stats, const SlotSummary* summary) {
+    stats->discs++;
+    stats->tracks += summary->track_count;
+    stats->seconds += summary->length;
+    int32_t decade = collection_stats_decade(summary->year);
+    if(decade >= 0 && stats->decade[decade] < UINT8_MAX) {
+        stats->decade[decade]++;
+    }
+    collection_stats_count(stats->genre, summary->genre, 1);
+    collection_stats_count(stats->artist, summary->artist, 1);
+}
+
+void collection_stats_remove(CollectionStats* stats, const SlotSummary* summary) {
+    if(stats->discs > 0) stats->discs--;
+    stats->tracks = stats->tracks > summary->track_count ? stats->tracks - summary->track_count : 0;
+    stats->seconds = stats->seconds > summary->length ? stats->seconds - summary->length : 0;
+    int32_t decade = collection_stats_decade(summary->year);
+    if(decade >= 0 && stats->decade[decade] > 0) {
+        stats->decade[decade]--;
+    }
+    collection_stats_count(stats->genre, summary->genre, -1);
+    collection_stats_count(stats->artist, summary->artist, -1);
+}
+
+uint16_t collection_stats_unknown_year(const CollectionStats* stats) {
+    uint16_t dated = 0;
+    for(int32_t i = 0; i < STATS_DECADES; i++) {
+        dated += stats->decade[i];
+    }
+    return stats->discs > dated ? stats->discs - dated : 0;
+}
+
+int32_t collection_stats_top(const uint8_t* counts, uint16_t* ids, int32_t max) {
+    // A few passes over the counts - max is small
+    int32_t found = 0;
+    while(found < max) {
+        int32_t best = -1;
+        for(int32_t i = 0; i < STRING_TABLE_MAX_ENTRIES; i++) {
+            if(counts[i] == 0 || (best >= 0 && counts[i] <= counts[best])) {
+                continue;
+            }
+            // Skip ids already taken
+            bool taken = false;
+            for(int32_t j = 0; j < found; j++) {
+                taken = taken || ids[j] == i + 1;
+            }
+            if(!taken) {
+                best = i;
+            }
+        }
+        if(best < 0) {
+            break;
+        }
+        ids[found++] = best + 1;
+    }
+    return found;
+}
@@ -0,0 +1,45 @@
+/**
+ * FlipChanger - Collection Statistics
+ *
+ * Running totals over every occupied slot: discs, tracks, playing time and
+ * discs per decade, genre and artist. Each disc's share comes from its
+ * summary, so a save or clear only takes the old summary out and puts the
+ * new one in - nothing is ever recounted from the card.
+ *
+ * The totals are stored with the summaries (see flipchanger_db.c).
+ */
+
+#pragma once
+
+#include "flipchanger.h"
+#include "flipchanger_strings.h"  // STRING_TABLE_MAX_ENTRIES
+
+#define STATS_FIRST_YEAR 1900  // Decade 0 - earlier years count as unknown
+#define STATS_DECADES 20       // 1900s to 2090s
+#define STATS_TOP 3            // Genres/artists shown
+
+struct CollectionStats {
+    uint16_t discs;                            // Occupied slots
+    uint16_t tracks;
+    uint32_t seconds;                          // Playing time of every disc
+    uint8_t decade[STATS_DECADES];             // Discs per decade (year unknown: not counted)
+    uint8_t genre[STRING_TABLE_MAX_ENTRIES];   // Discs per genre id (index = id - 1)
+    uint8_t artist[STRING_TABLE_MAX_ENTRIES];  // Discs per artist id
+};
+
+// Drop every total
+void collection_stats_reset(CollectionStats* stats);
+
+// Count one occupied slot in or out of the totals
+void collection_stats_add(CollectionStats* stats, const SlotSummary* summary);
+void collection_stats_remove(CollectionStats* stats, const SlotSummary* summary);
+
+// Decade bucket of a year (0 = 1900s), -1 if it has none
+int32_t collection_stats_decade(uint16_t year);
+
+// Discs of years outside the decade range (or no year)
+uint16_t collection_stats_unknown_year(const CollectionStats* stats);
+
+// Ids with the most discs in a genre/artist count array, most first (ties: lowest id) -
+// returns how many were found, at most max
+int32_t collection_stats_top(const uint8_t* counts, uint16_t* ids, int32_t max);
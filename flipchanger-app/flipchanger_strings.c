@@ -0,0 +1,223 @@
+/**
+ * FlipChanger - String Table
+ *
+ * Encoded layout: [id count] then per id [id][length][string], counts and
+ * ids little-endian uint16, lengths one byte, strings without terminators.
+ */
+
+#include "flipchanger_strings.h"
+#include <string.h>
+
+#define STRING_TABLE_GROW_POOL 256  // Pool bytes added per reallocation
+
+// Helper: Make room for at least pool_size pool bytes - false if the pool would pass 64 KB
+static bool string_table_reserve(StringTable* table, size_t pool_size) {
+    if(pool_size > UINT16_MAX) {
+        return false;
+    }
+    if(pool_size > table->pool_capacity) {
+        size_t capacity = ((pool_size + STRING_TABLE_GROW_POOL - 1) / STRING_TABLE_GROW_POOL) *
+                          STRING_TABLE_GROW_POOL;
+        if(capacity > UINT16_MAX) capacity = UINT16_MAX;
+        table->pool = realloc(table->pool, capacity);
+        table->pool_capacity = (uint16_t)capacity;
+    }
+    return true;
+}
+
+// Helper: Put a string under an id (the id must be free). Swept ids' bytes are reclaimed
+// once they outweigh the live strings (or the pool is full), so the pool stays within
+// about twice what is live
+static bool string_table_set(StringTable* table, uint16_t id, const char* text, size_t length) {
+    if(table->pool_dead > table->pool_size - table->pool_dead) {
+        string_table_compact(table);
+    }
+    if(!string_table_reserve(table, table->pool_size + length + 1)) {
+        string_table_compact(table);
+        if(!string_table_reserve(table, table->pool_size + length + 1)) {
+            return false;
+        }
+    }
+    uint16_t offset = table->pool_size;
+    memcpy(table->pool + offset, text, length);
+    table->pool[offset + length] = '\0';
+    table->pool_size += length + 1;
+
+    table->offset[id - 1] = offset;
+    if(id > table->count) {
+        table->count = id;
+    }
+    table->used++;
+    return true;
+}
+
+StringTable* string_table_alloc(void) {
+    StringTable* table = malloc(sizeof(StringTable));
+    memset(table, 0, sizeof(StringTable));
+    string_table_reset(table);
+    return table;
+}
+
+void string_table_free(StringTable* table) {
+    if(!table) return;
+    free(table->pool);
+    free(table);
+}
+
+void string_table_reset(StringTable* table) {
+    for(int32_t i = 0; i < STRING_TABLE_MAX_ENTRIES; i++) {
+        table->offset[i] = STRING_TABLE_FREE_OFFSET;
+    }
+    table->count = 0;
+    table->used = 0;
+    table->pool_size = 0;
+    table->pool_dead = 0;
+}
+
+uint16_t string_table_find(const StringTable* table, const char* text) {
+    if(!text[0]) {
+        return STRING_ID_NONE;
+    }
+    for(uint16_t i = 0; i < table->count; i++) {
+        if(table->offset[i] != STRING_TABLE_FREE_OFFSET &&
+           strcmp(table->pool + table->offset[i], text) == 0) {
+            return i + 1;
+        }
+    }
+    return STRING_ID_NONE;
+}
+
+uint16_t string_table_intern(StringTable* table, const char* text) {
+    uint16_t id = string_table_find(table, text);
+    if(id != STRING_ID_NONE || !text[0]) {
+        return id;
+    }
+
+    // Lowest free id keeps the range (and the encoding) small
+    for(uint16_t i = 0; i < STRING_TABLE_MAX_ENTRIES; i++) {
+        if(table->offset[i] == STRING_TABLE_FREE_OFFSET) {
+            size_t length = strnlen(text, STRING_TABLE_MAX_LENGTH - 1);
+            return string_table_set(table, i + 1, text, length) ? i + 1 : STRING_ID_NONE;
+        }
+    }
+    return STRING_ID_NONE;
+}
+
+const char* string_table_get(const StringTable* table, uint16_t id) {
+    if(id == STRING_ID_NONE || id > table->count ||
+       table->offset[id - 1] == STRING_TABLE_FREE_OFFSET) {
+        return "";
+    }
+    return table->pool + table->offset[id - 1];
+}
+
+uint16_t string_table_sweep(StringTable* table, const uint32_t* live) {
+    uint16_t freed = 0;
+    for(uint16_t i = 0; i < table->count; i++) {
+        if(table->offset[i] != STRING_TABLE_FREE_OFFSET && !((live[i / 32] >> (i % 32)) & 1u)) {
+            table->pool_dead += strlen(table->pool + table->offset[i]) + 1;
+            table->offset[i] = STRING_TABLE_FREE_OFFSET;
+            table->used--;
+            freed++;
+        }
+    }
+    return freed;
+}
+
+void string_table_compact(StringTable* table) {
+    // Live strings in pool order - each moves down to the end of the ones before it, and
+    // every string not moved yet still sits past the last one moved
+    uint16_t size = 0;
+    size_t floor = 0;
+    while(true) {
+        int32_t next = -1;
+        for(uint16_t i = 0; i < table->count; i++) {
+            if(table->offset[i] != STRING_TABLE_FREE_OFFSET && table->offset[i] >= floor &&
+               (next < 0 || table->offset[i] < table->offset[next])) {
+                next = i;
+            }
+        }
+        if(next < 0) {
+            break;
+        }
+        uint16_t from = table->offset[next];
+        size_t length = strlen(table->pool + from) + 1;
+        memmove(table->pool + size, table->pool + from, length);
+        table->offset[next] = size;
+        size += length;
+        floor = from + length;
+    }
+    table->pool_size = size;
+    table->pool_dead = 0;
+
+    // Keep one step of slack so the intern that triggered this does not grow it right back
+    size_t capacity =
+        ((size + 2 * STRING_TABLE_GROW_POOL - 1) / STRING_TABLE_GROW_POOL) * STRING_TABLE_GROW_POOL;
+    if(capacity < table->pool_capacity) {
+        table->pool = realloc(table->pool, capacity);
+        table->pool_capacity = (uint16_t)capacity;
+    }
+}
+
+uint16_t string_table_free_ids(const StringTable* table) {
+    return STRING_TABLE_MAX_ENTRIES - table->used;
+}
+
+size_t string_table_encoded_size(const StringTable* table) {
+    size_t size = 2;
+    for(uint16_t i = 0; i < table->count; i++) {
+        if(table->offset[i] != STRING_TABLE_FREE_OFFSET) {
+            size += 3 + strlen(table->pool + table->offset[i]);
+        }
+    }
+    return size;
+}
+
+size_t string_table_encode(const StringTable* table, uint8_t* buffer) {
+    size_t position = 0;
+    buffer[position++] = (uint8_t)(table->used & 0xFF);
+    buffer[position++] = (uint8_t)(table->used >> 8);
+    for(uint16_t i = 0; i < table->count; i++) {
+        if(table->offset[i] == STRING_TABLE_FREE_OFFSET) continue;
+        const char* text = table->pool + table->offset[i];
+        size_t length = strlen(text);
+        uint16_t id = i + 1;
+
+        buffer[position++] = (uint8_t)(id & 0xFF);
+        buffer[position++] = (uint8_t)(id >> 8);
+        buffer[position++] = (uint8_t)length;
+        memcpy(buffer + position, text, length);
+        position += length;
+    }
+    return position;
+}
+
+bool string_table_decode(StringTable* table, const uint8_t* buffer, size_t size) {
+    string_table_reset(table);
+    if(size < 2) {
+        return false;
+    }
+
+    uint16_t used = (uint16_t)(buffer[0] | (buffer[1] << 8));
+    bool valid = used <= STRING_TABLE_MAX_ENTRIES;
+    size_t position = 2;
+    for(uint16_t i = 0; valid && i < used; i++) {
+        // Never trust on-disk ids and lengths
+        valid = position + 3 <= size;
+        if(!valid) break;
+        uint16_t id = (uint16_t)(buffer[position] | (buffer[position + 1] << 8));
+        size_t length = buffer[position + 2];
+        position += 3;
+        valid = id != STRING_ID_NONE && id <= STRING_TABLE_MAX_ENTRIES &&
+                table->offset[id - 1] == STRING_TABLE_FREE_OFFSET && length > 0 &&
+                length < STRING_TABLE_MAX_LENGTH && position + length <= size &&
+                memchr(buffer + position, '\0', length) == NULL &&
+                string_table_set(table, id, (const char*)buffer + position, length);
+        position += length;
+    }
+
+    if(!valid) {
+        string_table_reset(table);
+    }
+    return valid;
+}
@@ -0,0 +1,68 @@
+/**
+ * FlipChanger - String Table
+ *
+ * Interned artist and genre names: each distinct string is stored once and
+ * slots refer to it by a small id, so equal names compare as equal ids.
+ * Strings sit back to back in one pool; id 0 is the empty string.
+ *
+ * On disk the table is one blob (see string_table_encode).
+ */
+
+#pragma once
+
+#include <furi.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define STRING_ID_NONE 0
+#define STRING_TABLE_MAX_ENTRIES 640    // Live ids never exceed 2 * MAX_SLOTS
+#define STRING_TABLE_MAX_LENGTH 64      // Including terminator
+#define STRING_TABLE_FREE_OFFSET 0xFFFF // Id not in use
+
+typedef struct {
+    uint16_t offset[STRING_TABLE_MAX_ENTRIES];  // Pool offset per id (index = id - 1)
+    uint16_t count;                             // Ids handed out so far (highest id)
+    uint16_t used;                              // Ids currently in use
+    char* pool;                                 // NUL-terminated strings, back to back
+    uint16_t pool_size;
+    uint16_t pool_capacity;
+    uint16_t pool_dead;                         // Bytes left behind by freed ids
+} StringTable;
+
+// Allocation
+StringTable* string_table_alloc(void);
+void string_table_free(StringTable* table);
+
+// Drop every string
+void string_table_reset(StringTable* table);
+
+// Id of a string, STRING_ID_NONE if it is empty or not in the table
+uint16_t string_table_find(const StringTable* table, const char* text);
+
+// Id of a string, adding it if needed - STRING_ID_NONE if it is empty or the table is full.
+// The pool is compacted first once freed ids hold more of it than live ones (or it is
+// full), so strings returned before may move
+uint16_t string_table_intern(StringTable* table, const char* text);
+
+// String of an id ("" for STRING_ID_NONE and ids not in use)
+const char* string_table_get(const StringTable* table, uint16_t id);
+
+// Free every id whose bit is clear in live (one bit per id, bit 0 = id 1). Pool bytes
+// are not moved - readers of live ids are never disturbed; the next intern reclaims them
+uint16_t string_table_sweep(StringTable* table, const uint32_t* live);
+
+// Move live strings down over the bytes freed ids left behind and give the spare pool
+// back to the heap (ids keep their strings)
+void string_table_compact(StringTable* table);
+
+// Ids left before the table is full
+uint16_t string_table_free_ids(const StringTable* table);
+
+// Encoding for storage: [count] then per id in use [id][length][string]
+size_t string_table_encoded_size(const StringTable* table);
+size_t string_table_encode(const StringTable* table, uint8_t* buffer);
+
+// Replace table contents from an encoded blob - false (and an empty table) if it is malformed
+bool string_table_decode(StringTable* table, const uint8_t* buffer, size_t size);
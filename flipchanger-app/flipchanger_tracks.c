@@ -0,0 +1,250 @@
+/**
+ * FlipChanger - Track Lists
+ *
+ * Encoded layout: [count] then per track [number][title length][title]
+ * [duration], lengths and counts one byte, titles without terminators,
+ * durations as little-endian uint16 seconds.
+ */
+
+#include "flipchanger_tracks.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TRACK_LIST_GROW_TRACKS 8   // Track entries added per reallocation
+#define TRACK_LIST_GROW_POOL 128   // Pool bytes added per reallocation
+
+// Helper: Make room for at least tracks entries and pool_size pool bytes
+static void track_list_reserve(TrackList* list, int32_t tracks, size_t pool_size) {
+    if(tracks > list->capacity) {
+        int32_t capacity =
+            ((tracks + TRACK_LIST_GROW_TRACKS - 1) / TRACK_LIST_GROW_TRACKS) * TRACK_LIST_GROW_TRACKS;
+        list->tracks = realloc(list->tracks, capacity * sizeof(Track));
+        list->capacity = capacity;
+    }
+    if(pool_size > list->pool_capacity) {
+        size_t capacity =
+            ((pool_size + TRACK_LIST_GROW_POOL - 1) / TRACK_LIST_GROW_POOL) * TRACK_LIST_GROW_POOL;
+        list->pool = realloc(list->pool, capacity);
+        list->pool_capacity = (uint16_t)capacity;
+    }
+}
+
+// Helper: Add a title to the end of the pool, returns its offset
+static uint16_t track_list_pool_add(TrackList* list, const char* title) {
+    size_t length = strnlen(title, MAX_TRACK_TITLE_LENGTH - 1);
+    track_list_reserve(list, list->count, list->pool_size + length + 1);
+    uint16_t offset = list->pool_size;
+    memcpy(list->pool + offset, title, length);
+    list->pool[offset + length] = '\0';
+    list->pool_size += length + 1;
+    return offset;
+}
+
+// Helper: Drop a title from the pool - later titles move down
+static void track_list_pool_remove(TrackList* list, uint16_t offset) {
+    size_t length = strlen(list->pool + offset) + 1;
+    memmove(list->pool + offset, list->pool + offset + length, list->pool_size - offset - length);
+    list->pool_size -= length;
+    for(int32_t i = 0; i < list->count; i++) {
+        if(list->tracks[i].title > offset) {
+            list->tracks[i].title -= length;
+        }
+    }
+}
+
+TrackList* track_list_alloc(void) {
+    TrackList* list = malloc(sizeof(TrackList));
+    memset(list, 0, sizeof(TrackList));
+    return list;
+}
+
+void track_list_free(TrackList* list) {
+    if(!list) return;
+    free(list->tracks);
+    free(list->pool);
+    free(list);
+}
+
+void track_list_reset(TrackList* list) {
+    list->count = 0;
+    list->pool_size = 0;
+}
+
+void track_list_copy(TrackList* dst, const TrackList* src) {
+    track_list_reserve(dst, src->count, src->pool_size);
+    if(src->count > 0) {
+        memcpy(dst->tracks, src->tracks, src->count * sizeof(Track));
+    }
+    if(src->pool_size > 0) {
+        memcpy(dst->pool, src->pool, src->pool_size);
+    }
+    dst->count = src->count;
+    dst->pool_size = src->pool_size;
+}
+
+bool track_list_append(TrackList* list, uint8_t number, const char* title, uint16_t duration) {
+    if(list->count >= MAX_TRACKS) {
+        return false;
+    }
+    track_list_reserve(list, list->count + 1, list->pool_size);
+
+    // Title first - growing the pool must not see a half-added entry
+    uint16_t offset = track_list_pool_add(list, title);
+    Track* track = &list->tracks[list->count];
+    memset(track, 0, sizeof(Track));
+    track->number = number;
+    track->title = offset;
+    track->duration = duration;
+    list->count++;
+    return true;
+}
+
+void track_list_remove(TrackList* list, int32_t index) {
+    if(index < 0 || index >= list->count) {
+        return;
+    }
+    track_list_pool_remove(list, list->tracks[index].title);
+    memmove(
+        &list->tracks[index],
+        &list->tracks[index + 1],
+        (list->count - index - 1) * sizeof(Track));
+    list->count--;
+}
+
+const char* track_list_title(const TrackList* list, int32_t index) {
+    if(index < 0 || index >= list->count) {
+        return "";
+    }
+    return list->pool + list->tracks[index].title;
+}
+
+void track_list_set_title(TrackList* list, int32_t index, const char* title) {
+    if(index < 0 || index >= list->count) {
+        return;
+    }
+
+    // Title may point into the pool, which is about to move
+    char copy[MAX_TRACK_TITLE_LENGTH];
+    strncpy(copy, title, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = '\0';
+
+    track_list_pool_remove(list, list->tracks[index].title);
+    list->tracks[index].title = track_list_pool_add(list, copy);
+}
+
+uint32_t track_list_total_duration(const TrackList* list) {
+    uint32_t total = 0;
+    for(int32_t i = 0; i < list->count; i++) {
+        total += list->tracks[i].duration;
+    }
+    return total;
+}
+
+void track_duration_format(uint32_t seconds, char* buffer, size_t buffer_size) {
+    if(seconds == 0) {
+        buffer[0] = '\0';
+    } else if(seconds >= 3600) {
+        snprintf(
+            buffer,
+            buffer_size,
+            "%lu:%02lu:%02lu",
+            (unsigned long)(seconds / 3600),
+            (unsigned long)(seconds / 60 % 60),
+            (unsigned long)(seconds % 60));
+    } else {
+        snprintf(
+            buffer,
+            buffer_size,
+            "%lu:%02lu",
+            (unsigned long)(seconds / 60),
+            (unsigned long)(seconds % 60));
+    }
+}
+
+uint16_t track_duration_parse(const char* text) {
+    // Each ':' moves what was read so far up one unit (seconds -> minutes -> hours)
+    uint32_t total = 0;
+    uint32_t part = 0;
+    bool digits = false;
+    for(const char* c = text; *c; c++) {
+        if(*c >= '0' && *c <= '9') {
+            part = part * 10 + (*c - '0');
+            digits = true;
+            if(part > UINT16_MAX) {
+                return UINT16_MAX;
+            }
+        } else if(*c == ':') {
+            total = (total + part) * 60;
+            part = 0;
+        } else if(*c != ' ') {
+            return 0;
+        }
+        if(total > UINT16_MAX) {
+            return UINT16_MAX;
+        }
+    }
+    if(!digits) {
+        return 0;
+    }
+    total += part;
+    return total > UINT16_MAX ? UINT16_MAX : (uint16_t)total;
+}
+
+size_t track_list_encoded_size(const TrackList* list) {
+    size_t size = 1;
+    for(int32_t i = 0; i < list->count; i++) {
+        size += 4 + strlen(track_list_title(list, i));
+    }
+    return size;
+}
+
+size_t track_list_encode(const TrackList* list, uint8_t* buffer) {
+    size_t position = 0;
+    buffer[position++] = (uint8_t)list->count;
+    for(int32_t i = 0; i < list->count; i++) {
+        const Track* track = &list->tracks[i];
+        const char* title = track_list_title(list, i);
+        size_t title_length = strlen(title);
+
+        buffer[position++] = track->number;
+        buffer[position++] = (uint8_t)title_length;
+        memcpy(buffer + position, title, title_length);
+        position += title_length;
+        buffer[position++] = (uint8_t)(track->duration & 0xFF);
+        buffer[position++] = (uint8_t)(track->duration >> 8);
+    }
+    return position;
+}
+
+bool track_list_decode(TrackList* list, const uint8_t* buffer, size_t size) {
+    track_list_reset(list);
+    if(size == 0) {
+        return true;  // Never written - no tracks
+    }
+
+    int32_t count = buffer[0];
+    bool valid = count <= MAX_TRACKS;
+    size_t position = 1;
+    char title[MAX_TRACK_TITLE_LENGTH];
+    for(int32_t i = 0; valid && i < count; i++) {
+        // Never trust on-disk lengths
+        valid = position + 2 <= size && buffer[position + 1] < MAX_TRACK_TITLE_LENGTH &&
+                position + 4 + buffer[position + 1] <= size;
+        if(!valid) break;
+        uint8_t number = buffer[position++];
+        size_t title_length = buffer[position++];
+        memcpy(title, buffer + position, title_length);
+        title[title_length] = '\0';
+        position += title_length;
+
+        uint16_t duration = (uint16_t)(buffer[position] | (buffer[position + 1] << 8));
+        position += 2;
+
+        track_list_append(list, number, title, duration);
+    }
+
+    if(!valid) {
+        track_list_reset(list);
+    }
+    return valid;
+}
@@ -0,0 +1,78 @@
+/**
+ * FlipChanger - Track Lists
+ *
+ * A disc's tracks in two growable buffers: a small Track entry per track
+ * and a pool holding every title back to back. Both are sized to the
+ * disc actually loaded, so a short disc costs a few hundred bytes while
+ * a long one can hold up to MAX_TRACKS tracks.
+ *
+ * On disk a list is one variable-length blob (see track_list_encode).
+ */
+
+#pragma once
+
+#include <furi.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define MAX_TRACKS 99
+#define MAX_TRACK_TITLE_LENGTH 64     // Including terminator
+#define MAX_TRACK_DURATION_LENGTH 16  // Duration as text ("3:45"), including terminator
+
+// Largest encoded list: count, then number, length-prefixed title and duration per track
+#define TRACK_LIST_MAX_ENCODED_SIZE (1 + MAX_TRACKS * (4 + (MAX_TRACK_TITLE_LENGTH - 1)))
+
+// Track information
+typedef struct {
+    uint16_t title;     // Offset of the title in the list's pool
+    uint16_t duration;  // Seconds (0 = unknown) - formatted only for display and export
+    uint8_t number;
+} Track;
+
+// Track list of one CD
+typedef struct {
+    int32_t count;
+    int32_t capacity;        // Track entries allocated
+    Track* tracks;
+    char* pool;              // NUL-terminated titles, back to back
+    uint16_t pool_size;      // Bytes in use
+    uint16_t pool_capacity;  // Bytes allocated
+} TrackList;
+
+// Allocation (an empty list allocates nothing else)
+TrackList* track_list_alloc(void);
+void track_list_free(TrackList* list);
+
+// Drop all tracks, keeping the buffers for reuse
+void track_list_reset(TrackList* list);
+
+// Make dst an exact copy of src
+void track_list_copy(TrackList* dst, const TrackList* src);
+
+// Add track at the end - false if the list is full
+bool track_list_append(TrackList* list, uint8_t number, const char* title, uint16_t duration);
+
+// Remove track, later tracks move up (numbers are left to the caller)
+void track_list_remove(TrackList* list, int32_t index);
+
+// Title access ("" for an index out of range)
+const char* track_list_title(const TrackList* list, int32_t index);
+void track_list_set_title(TrackList* list, int32_t index, const char* title);
+
+// Running time of the whole list in seconds
+uint32_t track_list_total_duration(const TrackList* list);
+
+// Duration text: "m:ss" ("h:mm:ss" from an hour up, "" for 0)
+void track_duration_format(uint32_t seconds, char* buffer, size_t buffer_size);
+
+// Parse "m:ss", "h:mm:ss" or plain seconds - 0 if unreadable, capped at UINT16_MAX
+uint16_t track_duration_parse(const char* text);
+
+// Variable-length encoding for storage
+size_t track_list_encoded_size(const TrackList* list);
+size_t track_list_encode(const TrackList* list, uint8_t* buffer);
+
+// Replace list contents from an encoded blob - false (and an empty list) if it is malformed
+bool track_list_decode(TrackList* list, const uint8_t* buffer, size_t size);
@@ -0,0 +1,147 @@
+/**
+ * FlipChanger - Storage Worker
+ *
+ * Requests run one at a time in the order they were posted, so a save
+ * always lands before a later load of the same slot. The worker never
+ * holds app->mutex while touching the card - it only takes it to hand
+ * results over (see flipchanger_install_slot / flipchanger_write_slot).
+ */
+
+#include "flipchanger_worker.h"
+#include "flipchanger_db.h"
+
+#define TAG "FlipChangerWorker"
+
+#define STORAGE_WORKER_STACK_SIZE 3072  // Same as the app stack - the JSON export runs here
+
+struct FlipChangerWorker {
+    FlipChangerApp* app;
+    FuriThread* thread;
+    FuriMessageQueue* queue;
+};
+
+// Helper: Run one request - returns its result
+static bool flipchanger_worker_run(
+    FlipChangerApp* app,
+    StorageRequest* request,
+    Slot* scratch,
+    TrackList* tracks) {
+    bool result = false;
+    switch(request->type) {
+        case StorageRequestLoad:
+            result = flipchanger_read_slot(app, request->slot_index, scratch);
+            flipchanger_install_slot(app, request->slot_index, result ? scratch : NULL);
+            break;
+        case StorageRequestSave:
+            result = flipchanger_write_slot(app, request->slot_index, request->slot);
+            free(request->slot);
+            break;
+        case StorageRequestLoadTracks:
+            result = flipchanger_read_tracks(app, request->slot_index, tracks);
+            flipchanger_install_tracks(app, request->slot_index, result ? tracks : NULL);
+            break;
+        case StorageRequestSaveTracks:
+            result = flipchanger_write_tracks(app, request->slot_index, request->tracks);
+            track_list_free(request->tracks);
+            break;
+        case StorageRequestSearch: {
+            // Results are large for the worker stack
+            SearchResults* results = malloc(sizeof(SearchResults));
+            result = flipchanger_search(app, request->query, results);
+            flipchanger_install_search(app, request->query, results);
+            free(results);
+            free(request->query);
+            break;
+        }
+        case StorageRequestFlush:
+            // Every save posted before this one is journaled by now
+            result = !app->export_pending || flipchanger_save_data(app);
+            break;
+        case StorageRequestCompact:
+            result = flipchanger_db_compact(app->db);
+            break;
+        case StorageRequestStop:
+            break;
+    }
+    return result;
+}
+
+static int32_t flipchanger_worker_thread(void* context) {
+    FlipChangerWorker* worker = context;
+    FlipChangerApp* app = worker->app;
+
+    // Load targets live on the heap (worker stack is small)
+    Slot* scratch = malloc(sizeof(Slot));
+    TrackList* tracks = track_list_alloc();
+    StorageRequest request;
+    while(furi_message_queue_get(worker->queue, &request, FuriWaitForever) == FuriStatusOk) {
+        if(request.type == StorageRequestStop) {
+            break;
+        }
+
+        bool result = flipchanger_worker_run(app, &request, scratch, tracks);
+        if(!result) {
+            FURI_LOG_W(
+                TAG, "Request %d for slot %ld failed", request.type, (long)(request.slot_index + 1));
+        }
+
+        // Tell the app thread - never wait on its queue (it may be waiting on ours). A full
+        // queue keeps the app thread busy, and it handles the completion it turned away
+        // after its next event
+        FlipChangerEvent event = {
+            .type = FlipChangerEventTypeStorage,
+            .storage = {.request = request.type, .slot_index = request.slot_index, .result = result},
+        };
+        if(furi_message_queue_put(app->event_queue, &event, 0) != FuriStatusOk) {
+            furi_mutex_acquire(app->mutex, FuriWaitForever);
+            app->storage_event_missed = true;
+            furi_mutex_release(app->mutex);
+        }
+    }
+    track_list_free(tracks);
+    free(scratch);
+    free(app->search_session);
+    app->search_session = NULL;
+    return 0;
+}
+
+FlipChangerWorker* flipchanger_worker_alloc(FlipChangerApp* app) {
+    FlipChangerWorker* worker = malloc(sizeof(FlipChangerWorker));
+    worker->app = app;
+    worker->queue = furi_message_queue_alloc(STORAGE_QUEUE_SIZE, sizeof(StorageRequest));
+    worker->thread = furi_thread_alloc_ex(
+        "FlipChangerStorage", STORAGE_WORKER_STACK_SIZE, flipchanger_worker_thread, worker);
+    furi_thread_start(worker->thread);
+    return worker;
+}
+
+void flipchanger_worker_free(FlipChangerWorker* worker) {
+    if(!worker) return;
+
+    // Stop goes to the back of the queue - everything before it still runs
+    StorageRequest stop = {.type = StorageRequestStop};
+    furi_message_queue_put(worker->queue, &stop, FuriWaitForever);
+    furi_thread_join(worker->thread);
+    furi_thread_free(worker->thread);
+
+    // Anything left (nothing, unless posted after stop) still owns its heap copy
+    StorageRequest request;
+    while(furi_message_queue_get(worker->queue, &request, 0) == FuriStatusOk) {
+        if(request.type == StorageRequestSave) {
+            free(request.slot);
+        } else if(request.type == StorageRequestSaveTracks) {
+            track_list_free(request.tracks);
+        } else if(request.type == StorageRequestSearch) {
+            free(request.query);
+        }
+    }
+    furi_message_queue_free(worker->queue);
+    free(worker);
+}
+
+bool flipchanger_worker_post(
+    FlipChangerWorker* worker,
+    const StorageRequest* request,
+    uint32_t timeout) {
+    return furi_message_queue_put(worker->queue, request, timeout) == FuriStatusOk;
+}
@@ -0,0 +1,34 @@
+/**
+ * FlipChanger - Storage Worker
+ *
+ * Background thread that owns all SD card I/O once the app is running.
+ * The app thread posts typed requests and carries on; each finished
+ * request is reported back on the app's event queue.
+ */
+
+#pragma once
+
+#include "flipchanger.h"
+
+// Pending requests (loads beyond this are dropped - saves are never posted past it)
+#define STORAGE_QUEUE_SIZE 16
+
+typedef struct {
+    StorageRequestType type;
+    int32_t slot_index;
+    union {
+        Slot* slot;          // Save only - heap copy, freed by the worker
+        TrackList* tracks;   // SaveTracks only - same
+        char* query;         // Search only - same
+    };
+} StorageRequest;
+
+// Start/stop (free finishes every queued request first)
+FlipChangerWorker* flipchanger_worker_alloc(FlipChangerApp* app);
+void flipchanger_worker_free(FlipChangerWorker* worker);
+
+// Queue request - returns false if the queue stayed full for timeout
+bool flipchanger_worker_post(
+    FlipChangerWorker* worker,
+    const StorageRequest* request,
+    uint32_t timeout);